@@ -0,0 +1,131 @@
+#ifndef AISDI_LINEAR_ALLOCATOR_H
+#define AISDI_LINEAR_ALLOCATOR_H
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "Config.h"
+
+#if AISDI_PMR
+#include <memory_resource>
+#endif
+
+namespace aisdi
+{
+
+    // Keeps the allocator of a container. Stateless allocators, like
+    // std::allocator, are an empty base and make the container no bigger.
+    template <typename Allocator, bool = std::is_empty<Allocator>::value>
+    class AllocatorHolder : private Allocator
+    {
+    protected:
+        explicit AllocatorHolder(const Allocator& allocator_) : Allocator(allocator_)
+        {}
+
+        Allocator& allocator()
+        {
+            return *this;
+        }
+
+        const Allocator& allocator() const
+        {
+            return *this;
+        }
+    };
+
+    template <typename Allocator>
+    class AllocatorHolder<Allocator, false>
+    {
+    private:
+        Allocator stored;
+
+    protected:
+        explicit AllocatorHolder(const Allocator& allocator_) : stored(allocator_)
+        {}
+
+        Allocator& allocator()
+        {
+            return stored;
+        }
+
+        const Allocator& allocator() const
+        {
+            return stored;
+        }
+    };
+
+    // What a container does with its allocator when it is copied, moved or
+    // swapped, as std::allocator_traits tells it.
+    template <typename Allocator>
+    struct AllocatorPropagation
+    {
+        using Traits = std::allocator_traits<Allocator>;
+        using OnCopy = typename Traits::propagate_on_container_copy_assignment;
+        using OnMove = typename Traits::propagate_on_container_move_assignment;
+        using OnSwap = typename Traits::propagate_on_container_swap;
+
+        static Allocator copyFor(const Allocator& allocator_)
+        {
+            return Traits::select_on_container_copy_construction(allocator_);
+        }
+
+        // Storage can change hands between containers whose allocators will
+        // be equal afterwards.
+        static bool canMove(const Allocator& target, const Allocator& source)
+        {
+            return OnMove::value || target == source;
+        }
+
+        static void assignOnCopy(Allocator& target, const Allocator& source)
+        {
+            assign(target, source, OnCopy());
+        }
+
+        static void assignOnMove(Allocator& target, Allocator& source)
+        {
+            assign(target, std::move(source), OnMove());
+        }
+
+        // For containers that hand their storage over to a copy or to the
+        // source of a move instead of freeing it: the allocators go with
+        // the storage.
+        static void swapOnCopy(Allocator& target, Allocator& source)
+        {
+            swap(target, source, OnCopy());
+        }
+
+        static void swapOnMove(Allocator& target, Allocator& source)
+        {
+            swap(target, source, OnMove());
+        }
+
+        static void swapOnSwap(Allocator& first, Allocator& second)
+        {
+            swap(first, second, OnSwap());
+        }
+
+    private:
+        template <typename Source>
+        static void assign(Allocator& target, Source&& source, std::true_type)
+        {
+            target = std::forward<Source>(source);
+        }
+
+        template <typename Source>
+        static void assign(Allocator&, Source&&, std::false_type)
+        {}
+
+        static void swap(Allocator& first, Allocator& second, std::true_type)
+        {
+            using std::swap;
+            swap(first, second);
+        }
+
+        static void swap(Allocator&, Allocator&, std::false_type)
+        {}
+    };
+
+}
+
+#endif // AISDI_LINEAR_ALLOCATOR_H
@@ -0,0 +1,212 @@
+#ifndef AISDI_LINEAR_BENCHMARK_H
+#define AISDI_LINEAR_BENCHMARK_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace aisdi
+{
+
+    // Keeps the optimizer from discarding work whose result is otherwise unused.
+    template <typename T>
+    inline void doNotOptimize(const T& value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static const volatile void* sink;
+        sink = &value;
+#endif
+    }
+
+    struct BenchmarkResult
+    {
+        std::string name;
+        std::string container;
+        std::string type;
+        std::size_t size;
+        std::size_t operations;
+        std::size_t repetitions;
+        // Seconds per repetition.
+        double min;
+        double median;
+        double p99;
+        // Bytes each operation moves; 0 when throughput is not meaningful.
+        double bytesPerOperation;
+        std::vector<std::pair<std::string, double>> counters;
+
+        double opsPerSecond() const
+        {
+            return median > 0 ? operations / median : 0;
+        }
+
+        double gigabytesPerSecond() const
+        {
+            return median > 0 ? bytesPerOperation * operations / median / 1e9 : 0;
+        }
+    };
+
+    // Runs every benchmark warmups + repetitions times and keeps order
+    // statistics of the timed repetitions. Results can be written as an
+    // aligned table, CSV or JSON, so runs of different builds can be diffed.
+    class BenchmarkSuite
+    {
+    private:
+        std::size_t repetitions;
+        std::size_t warmups;
+        std::string filter;
+        std::vector<std::pair<std::string, std::string>> context;
+        std::vector<BenchmarkResult> results;
+
+        static std::string escape(const std::string& text)
+        {
+            std::string escaped;
+            for (char c : text)
+            {
+                if (c == '"' || c == '\\')
+                    escaped += '\\';
+                escaped += c;
+            }
+            return escaped;
+        }
+
+        static std::string countersText(const BenchmarkResult& result)
+        {
+            std::ostringstream text;
+            for (std::size_t i = 0; i < result.counters.size(); ++i)
+                text << (i ? ";" : "") << result.counters[i].first << "=" << result.counters[i].second;
+            return text.str();
+        }
+
+    public:
+        explicit BenchmarkSuite(std::size_t repetitions_ = 11, std::size_t warmups_ = 1, const std::string& filter_ = "")
+        {
+            repetitions = repetitions_ == 0 ? 1 : repetitions_;
+            warmups = warmups_;
+            filter = filter_;
+        }
+
+        void addContext(const std::string& key, const std::string& value)
+        {
+            context.push_back(std::make_pair(key, value));
+        }
+
+        bool selected(const std::string& name, const std::string& container, const std::string& type) const
+        {
+            return filter.empty() || (container + "/" + name + "/" + type).find(filter) != std::string::npos;
+        }
+
+        // setup() runs untimed before every repetition and returns the fixture
+        // body() works on; the fixture is destroyed after the clock stops.
+        // Returns nullptr when the filter skips the benchmark, otherwise the
+        // stored result, valid until the next run().
+        template <typename Setup, typename Body>
+        BenchmarkResult* run(const std::string& name, const std::string& container, const std::string& type,
+                             std::size_t size, std::size_t operations, Setup setup, Body body)
+        {
+            if (!selected(name, container, type))
+                return nullptr;
+
+            std::vector<double> samples;
+            for (std::size_t i = 0; i < warmups + repetitions; ++i)
+            {
+                auto fixture = setup();
+                auto start = std::chrono::steady_clock::now();
+                body(fixture);
+                auto finish = std::chrono::steady_clock::now();
+                if (i >= warmups)
+                    samples.push_back(std::chrono::duration<double>(finish - start).count());
+            }
+            std::sort(samples.begin(), samples.end());
+
+            BenchmarkResult result;
+            result.name = name;
+            result.container = container;
+            result.type = type;
+            result.size = size;
+            result.operations = operations;
+            result.repetitions = samples.size();
+            result.min = samples.front();
+            result.median = samples[samples.size() / 2];
+            result.p99 = samples[static_cast<std::size_t>(std::ceil(samples.size() * 0.99)) - 1];
+            result.bytesPerOperation = 0;
+            results.push_back(result);
+            return &results.back();
+        }
+
+        const std::vector<BenchmarkResult>& getResults() const
+        {
+            return results;
+        }
+
+        void writeTable(std::ostream& out) const
+        {
+            out << std::left << std::setw(26) << "benchmark" << std::setw(24) << "container" << std::setw(12) << "type"
+                << std::right << std::setw(11) << "size" << std::setw(11) << "ops"
+                << std::setw(12) << "min ms" << std::setw(12) << "median ms" << std::setw(12) << "p99 ms"
+                << std::setw(14) << "ops/s" << std::setw(9) << "GB/s" << "  counters\n";
+            for (const auto& result : results)
+            {
+                out << std::left << std::setw(26) << result.name << std::setw(24) << result.container << std::setw(12) << result.type
+                    << std::right << std::setw(11) << result.size << std::setw(11) << result.operations
+                    << std::fixed << std::setprecision(3)
+                    << std::setw(12) << result.min * 1e3 << std::setw(12) << result.median * 1e3 << std::setw(12) << result.p99 * 1e3
+                    << std::setprecision(0) << std::setw(14) << result.opsPerSecond()
+                    << std::setprecision(2) << std::setw(9) << result.gigabytesPerSecond()
+                    << "  " << countersText(result) << "\n";
+                out.unsetf(std::ios::fixed);
+            }
+        }
+
+        void writeCsv(std::ostream& out) const
+        {
+            out << "benchmark,container,type,size,operations,repetitions,min_s,median_s,p99_s,ops_per_s,gb_per_s,counters\n";
+            out << std::setprecision(9);
+            for (const auto& result : results)
+                out << result.name << "," << result.container << "," << result.type << ","
+                    << result.size << "," << result.operations << "," << result.repetitions << ","
+                    << result.min << "," << result.median << "," << result.p99 << ","
+                    << result.opsPerSecond() << "," << result.gigabytesPerSecond() << ","
+                    << countersText(result) << "\n";
+        }
+
+        void writeJson(std::ostream& out) const
+        {
+            out << std::setprecision(9) << "{\n  \"context\": {";
+            for (std::size_t i = 0; i < context.size(); ++i)
+                out << (i ? ", " : "") << "\"" << escape(context[i].first) << "\": \"" << escape(context[i].second) << "\"";
+            out << "},\n  \"benchmarks\": [";
+            for (std::size_t i = 0; i < results.size(); ++i)
+            {
+                const BenchmarkResult& result = results[i];
+                out << (i ? "," : "") << "\n    {\"benchmark\": \"" << escape(result.name)
+                    << "\", \"container\": \"" << escape(result.container)
+                    << "\", \"type\": \"" << escape(result.type)
+                    << "\", \"size\": " << result.size
+                    << ", \"operations\": " << result.operations
+                    << ", \"repetitions\": " << result.repetitions
+                    << ", \"min_s\": " << result.min
+                    << ", \"median_s\": " << result.median
+                    << ", \"p99_s\": " << result.p99
+                    << ", \"ops_per_s\": " << result.opsPerSecond()
+                    << ", \"gb_per_s\": " << result.gigabytesPerSecond()
+                    << ", \"counters\": {";
+                for (std::size_t c = 0; c < result.counters.size(); ++c)
+                    out << (c ? ", " : "") << "\"" << escape(result.counters[c].first) << "\": " << result.counters[c].second;
+                out << "}}";
+            }
+            out << "\n  ]\n}\n";
+        }
+    };
+
+}
+
+#endif // AISDI_LINEAR_BENCHMARK_H
@@ -0,0 +1,382 @@
+#ifndef AISDI_LINEAR_CONCURRENTQUEUE_H
+#define AISDI_LINEAR_CONCURRENTQUEUE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace aisdi
+{
+
+    // Multi-producer multi-consumer FIFO queue after Michael and Scott.
+    // append and tryPopFirst are lock-free: a thread stalled anywhere in
+    // them cannot keep the others from making progress. Unlinked nodes are
+    // reclaimed with hazard pointers, so a node is only reused once no
+    // thread can still be reading it. Reclaimed nodes go to a free list
+    // shared by every thread, so producers reuse what consumers free and a
+    // queue streaming any number of elements holds about as many nodes as
+    // its longest backlog. Like NodePool, nodes are carved out of growing
+    // chunks that are given back when the queue is destroyed.
+    //
+    // There are no iterators and no size, as both would be stale by the
+    // time the caller looked at them. Construction and destruction must not
+    // race with other operations.
+    template <typename Type>
+    class ConcurrentQueue
+    {
+    public:
+        using size_type = std::size_t;
+        using value_type = Type;
+        using reference = Type&;
+        using const_reference = const Type&;
+
+    private:
+        static const size_type CacheLine = 64;
+        // Retired nodes a record collects, on top of two per record, before
+        // it scans the hazard pointers.
+        static const size_type RetireBatch = 64;
+        static const size_type InitialChunkNodes = 16;
+        static const size_type MaxChunkNodes = 4096;
+
+        // Head is a dummy node: its value has already been popped or never
+        // existed. The queued elements live in the nodes after it.
+        struct Node
+        {
+            std::atomic<Node*> Next;
+            alignas(Type) unsigned char Storage[sizeof(Type)];
+
+            Node()
+                : Next(nullptr)
+            {}
+
+            Type* value()
+            {
+                return reinterpret_cast<Type*>(Storage);
+            }
+        };
+
+        // Every thread inside an operation owns one record. Its hazard slots
+        // name the nodes it may dereference, Retired holds the nodes it
+        // unlinked that other threads might still be reading, and Spare the
+        // free nodes its next appends will reuse. Only the owner touches
+        // the rest of the record, so its node chunks need no locking either.
+        // Records are reused by later operations and freed with the queue.
+        struct HazardRecord
+        {
+            std::atomic<Node*> Hazards[2];
+            std::atomic<bool> Active;
+            HazardRecord* Next;
+            std::vector<Node*> Retired;
+            std::vector<Node*> Spare;
+            std::vector<Node*> Chunks;
+            Node* Cursor;
+            Node* ChunkEnd;
+            size_type NextChunkNodes;
+            size_type ChunkBytes;
+
+            HazardRecord()
+                : Active(true), Next(nullptr), Cursor(nullptr), ChunkEnd(nullptr), NextChunkNodes(InitialChunkNodes), ChunkBytes(0)
+            {
+                Hazards[0].store(nullptr);
+                Hazards[1].store(nullptr);
+            }
+
+            ~HazardRecord()
+            {
+                for (Node* Chunk : Chunks)
+                    ::operator delete(Chunk);
+            }
+
+            Node* carveNode()
+            {
+                if (Cursor == ChunkEnd)
+                {
+                    Chunks.reserve(Chunks.size() + 1);
+                    Cursor = static_cast<Node*>(::operator new(NextChunkNodes * sizeof(Node)));
+                    Chunks.push_back(Cursor);
+                    ChunkEnd = Cursor + NextChunkNodes;
+                    ChunkBytes += NextChunkNodes * sizeof(Node);
+                    if (NextChunkNodes < MaxChunkNodes)
+                        NextChunkNodes *= 2;
+                }
+                return new (Cursor++) Node;
+            }
+        };
+
+        class HazardGuard
+        {
+        private:
+            HazardRecord* Record;
+
+        public:
+            explicit HazardGuard(ConcurrentQueue& queue)
+                : Record(queue.acquireRecord())
+            {}
+
+            HazardGuard(const HazardGuard&) = delete;
+            HazardGuard& operator=(const HazardGuard&) = delete;
+
+            ~HazardGuard()
+            {
+                Record->Hazards[0].store(nullptr, std::memory_order_release);
+                Record->Hazards[1].store(nullptr, std::memory_order_release);
+                Record->Active.store(false, std::memory_order_release);
+            }
+
+            HazardRecord* operator->() const
+            {
+                return Record;
+            }
+
+            HazardRecord* get() const
+            {
+                return Record;
+            }
+        };
+
+        // Producers work on Tail and consumers on Head; keeping them on
+        // separate cache lines stops the two sides from invalidating each
+        // other's line on every operation.
+        std::atomic<Node*> Head;
+        char HeadPadding[CacheLine - sizeof(std::atomic<Node*>)];
+        std::atomic<Node*> Tail;
+        char TailPadding[CacheLine - sizeof(std::atomic<Node*>)];
+        std::atomic<HazardRecord*> Records;
+        std::atomic<size_type> RecordCount;
+        // Reclaimed nodes linked through Next. Chains are pushed with a CAS
+        // and the whole list is taken with an exchange, never single nodes
+        // popped, so the stack has no ABA problem.
+        std::atomic<Node*> FreeNodes;
+
+        HazardRecord* acquireRecord()
+        {
+            for (HazardRecord* Record = Records.load(std::memory_order_acquire); Record != nullptr; Record = Record->Next)
+                if (!Record->Active.load(std::memory_order_relaxed) && !Record->Active.exchange(true, std::memory_order_acquire))
+                    return Record;
+
+            HazardRecord* Record = new HazardRecord;
+            HazardRecord* First = Records.load(std::memory_order_relaxed);
+            do
+                Record->Next = First;
+            while (!Records.compare_exchange_weak(First, Record, std::memory_order_release, std::memory_order_relaxed));
+            RecordCount.fetch_add(1, std::memory_order_relaxed);
+            return Record;
+        }
+
+        // Publishes Source in Slot. Once Source still holds the published
+        // node afterwards, that node cannot be freed until Slot is cleared.
+        static Node* protect(const std::atomic<Node*>& Source, std::atomic<Node*>& Slot)
+        {
+            Node* Current = Source.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                Slot.store(Current);
+                Node* Again = Source.load();
+                if (Again == Current)
+                    return Current;
+                Current = Again;
+            }
+        }
+
+        // A spare of Record, else the shared free list moved to its spares,
+        // else a node of a new chunk.
+        Node* allocateNode(HazardRecord* Record)
+        {
+            if (Record->Spare.empty())
+            {
+                Node* Free = FreeNodes.exchange(nullptr, std::memory_order_acquire);
+                while (Free != nullptr)
+                {
+                    Record->Spare.push_back(Free);
+                    Free = Free->Next.load(std::memory_order_relaxed);
+                }
+            }
+            if (Record->Spare.empty())
+                return Record->carveNode();
+            Node* Reused = Record->Spare.back();
+            Record->Spare.pop_back();
+            Reused->Next.store(nullptr, std::memory_order_relaxed);
+            return Reused;
+        }
+
+        void retire(HazardRecord* Record, Node* Dead)
+        {
+            Record->Retired.push_back(Dead);
+            if (Record->Retired.size() >= 2 * RecordCount.load(std::memory_order_relaxed) + RetireBatch)
+                scan(Record);
+        }
+
+        // Moves every retired node of Record that no hazard slot names to
+        // the shared free list.
+        void scan(HazardRecord* Record)
+        {
+            std::vector<Node*> Hazards;
+            for (HazardRecord* Other = Records.load(std::memory_order_acquire); Other != nullptr; Other = Other->Next)
+                for (const auto& Hazard : Other->Hazards)
+                    if (Node* Held = Hazard.load())
+                        Hazards.push_back(Held);
+            std::sort(Hazards.begin(), Hazards.end());
+
+            auto Kept = Record->Retired.begin();
+            Node* First = nullptr;
+            Node* Last = nullptr;
+            for (Node* Dead : Record->Retired)
+                if (std::binary_search(Hazards.begin(), Hazards.end(), Dead))
+                    *Kept++ = Dead;
+                else
+                {
+                    Dead->Next.store(First, std::memory_order_relaxed);
+                    First = Dead;
+                    if (Last == nullptr)
+                        Last = Dead;
+                }
+            Record->Retired.erase(Kept, Record->Retired.end());
+            if (First == nullptr)
+                return;
+            Node* Free = FreeNodes.load(std::memory_order_relaxed);
+            do
+                Last->Next.store(Free, std::memory_order_relaxed);
+            while (!FreeNodes.compare_exchange_weak(Free, First, std::memory_order_release, std::memory_order_relaxed));
+        }
+
+    public:
+        ConcurrentQueue()
+            : Head(nullptr), Tail(nullptr), Records(nullptr), RecordCount(0), FreeNodes(nullptr)
+        {
+            HazardGuard Guard(*this);
+            Node* Dummy = allocateNode(Guard.get());
+            Head.store(Dummy);
+            Tail.store(Dummy);
+        }
+
+        ConcurrentQueue(const ConcurrentQueue&) = delete;
+        ConcurrentQueue& operator=(const ConcurrentQueue&) = delete;
+
+        ~ConcurrentQueue()
+        {
+            Node* Current = Head.load(std::memory_order_relaxed)->Next.load(std::memory_order_relaxed);
+            for (; Current != nullptr; Current = Current->Next.load(std::memory_order_relaxed))
+                Current->value()->~Type();
+
+            HazardRecord* Record = Records.load(std::memory_order_relaxed);
+            while (Record != nullptr)
+            {
+                HazardRecord* NextRecord = Record->Next;
+                delete Record;
+                Record = NextRecord;
+            }
+        }
+
+        // Bytes of the queue and of every node chunk it has taken. Must not
+        // race with other operations.
+        size_type getMemoryUsage() const
+        {
+            size_type Bytes = sizeof(ConcurrentQueue);
+            for (HazardRecord* Record = Records.load(std::memory_order_acquire); Record != nullptr; Record = Record->Next)
+                Bytes += sizeof(HazardRecord) + Record->ChunkBytes;
+            return Bytes;
+        }
+
+        // Only a snapshot: other threads may append or pop right after.
+        bool isEmpty()
+        {
+            HazardGuard Guard(*this);
+            return protect(Head, Guard->Hazards[0])->Next.load(std::memory_order_acquire) == nullptr;
+        }
+
+        void append(const Type& item)
+        {
+            emplaceBack(item);
+        }
+
+        void append(Type&& item)
+        {
+            emplaceBack(std::move(item));
+        }
+
+        template <typename... Args>
+        void emplaceBack(Args&&... args)
+        {
+            HazardGuard Guard(*this);
+            Node* NewNode = allocateNode(Guard.get());
+            try
+            {
+                new (NewNode->value()) Type(std::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                Guard->Spare.push_back(NewNode);
+                throw;
+            }
+
+            for (;;)
+            {
+                Node* Last = protect(Tail, Guard->Hazards[0]);
+                Node* Next = Last->Next.load(std::memory_order_acquire);
+                if (Next != nullptr)
+                {
+                    // Another producer linked its node but has not moved
+                    // Tail yet; finish that for it.
+                    Tail.compare_exchange_weak(Last, Next);
+                    continue;
+                }
+                if (Last->Next.compare_exchange_weak(Next, NewNode))
+                {
+                    Tail.compare_exchange_strong(Last, NewNode);
+                    return;
+                }
+            }
+        }
+
+        // Moves the first element into item and returns true, or returns
+        // false when the queue is empty. If moving into item throws, the
+        // element is lost.
+        bool tryPopFirst(Type& item)
+        {
+            HazardGuard Guard(*this);
+            for (;;)
+            {
+                Node* First = protect(Head, Guard->Hazards[0]);
+                Node* Next = First->Next.load(std::memory_order_acquire);
+                Guard->Hazards[1].store(Next);
+                if (Head.load() != First)
+                    continue;
+                if (Next == nullptr)
+                    return false;
+                Node* Last = Tail.load();
+                if (First == Last)
+                {
+                    // Next is linked but Tail lags behind; Head must never
+                    // pass Tail, or Tail could name a freed node.
+                    Tail.compare_exchange_weak(Last, Next);
+                    continue;
+                }
+                if (!Head.compare_exchange_weak(First, Next))
+                    continue;
+
+                // Next is the new dummy. Its value is ours alone, and the
+                // hazard on it keeps it alive until we are done.
+                Type* Value = Next->value();
+                try
+                {
+                    item = std::move(*Value);
+                }
+                catch (...)
+                {
+                    Value->~Type();
+                    retire(Guard.get(), First);
+                    throw;
+                }
+                Value->~Type();
+                retire(Guard.get(), First);
+                return true;
+            }
+        }
+    };
+
+}
+
+#endif // AISDI_LINEAR_CONCURRENTQUEUE_H
@@ -0,0 +1,75 @@
+#ifndef AISDI_LINEAR_CONFIG_H
+#define AISDI_LINEAR_CONFIG_H
+
+// Iterators of every aisdi container are bounds-checked and throw
+// std::out_of_range on misuse in debug and test builds. Release builds
+// (NDEBUG) compile the checks out, leaving raw-pointer-like iterators the
+// optimizer can vectorize. Define AISDI_CHECKED_ITERATORS as 0 or 1 to
+// override either default.
+#ifndef AISDI_CHECKED_ITERATORS
+#ifdef NDEBUG
+#define AISDI_CHECKED_ITERATORS 0
+#else
+#define AISDI_CHECKED_ITERATORS 1
+#endif
+#endif
+
+// The kernels of SimdKernels.h choose SSE2, AVX2 or AVX-512 code at run
+// time on x86 with GCC or Clang, and plain loops elsewhere. Define
+// AISDI_SIMD as 0 to always use the plain loops.
+#ifndef AISDI_SIMD
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define AISDI_SIMD 1
+#else
+#define AISDI_SIMD 0
+#endif
+#endif
+
+// POSIX file descriptors and mmap are there on Unix-like systems.
+// MappedVector.h needs them, and so do the fd overloads of
+// Serialization.h; AISDI_MAPPED_VECTOR tells whether the former is
+// available.
+#ifndef AISDI_POSIX
+#if defined(__unix__) || defined(__APPLE__)
+#define AISDI_POSIX 1
+#else
+#define AISDI_POSIX 0
+#endif
+#endif
+
+#ifndef AISDI_MAPPED_VECTOR
+#define AISDI_MAPPED_VECTOR AISDI_POSIX
+#endif
+
+// Vector and LinkedList count their allocations, frees, reallocations and
+// element copies and moves, per container and per family, when
+// AISDI_STATS is 1 (see Stats.h). Off by default, which compiles the
+// counters and every update of them out.
+#ifndef AISDI_STATS
+#define AISDI_STATS 0
+#endif
+
+// LinkedList iterators prefetch the node after the one they step to when
+// AISDI_PREFETCH is 1, so its cache miss overlaps the work on the current
+// element (GCC and Clang only). Worth it only when that work is sizeable:
+// a bare scan of scattered nodes waits on each load all the same, and
+// LinkedList::compact() is what speeds that up.
+#ifndef AISDI_PREFETCH
+#define AISDI_PREFETCH 0
+#endif
+
+// The aisdi::pmr aliases, containers on a std::pmr::memory_resource, need
+// C++17 and a standard library with <memory_resource>.
+#ifndef AISDI_PMR
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<memory_resource>)
+#define AISDI_PMR 1
+#else
+#define AISDI_PMR 0
+#endif
+#else
+#define AISDI_PMR 0
+#endif
+#endif
+
+#endif // AISDI_LINEAR_CONFIG_H
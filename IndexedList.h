@@ -0,0 +1,785 @@
+#ifndef AISDI_LINEAR_INDEXEDLIST_H
+#define AISDI_LINEAR_INDEXEDLIST_H
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "Config.h"
+
+namespace aisdi
+{
+
+    // Doubly linked list with an indexable skip list on top: every node
+    // keeps forward links on 1..MaxHeight levels, each with the number of
+    // positions it jumps over. Reaching any index, finding the index of an
+    // iterator and inserting or erasing anywhere are all expected O(log n);
+    // ++ and -- stay O(1) and iterators stay valid until their element is
+    // erased, as with LinkedList.
+    template <typename Type>
+    class IndexedList
+    {
+public:
+        using difference_type = std::ptrdiff_t;
+        using size_type = std::size_t;
+        using value_type = Type;
+        using pointer = Type*;
+        using reference = Type&;
+        using const_pointer = const Type*;
+        using const_reference = const Type&;
+
+        class ConstIterator;
+        class Iterator;
+        using iterator = Iterator;
+        using const_iterator = ConstIterator;
+
+private:
+        // One level above the tallest node is reserved: the head's link on
+        // it always points at the end sentinel and spans the whole list.
+        static const size_type MaxHeight = 31;
+        static const size_type TopLevel = MaxHeight;
+
+        struct NodeBase;
+
+        struct Link
+        {
+            NodeBase* Next;
+            size_type Span;
+        };
+
+        // Ranks count from the head sentinel (0); the element at index i
+        // has rank i + 1 and the end sentinel rank Size + 1. On the head,
+        // Height is the number of levels currently in use.
+        // A node's links sit right in front of it in memory, level 0
+        // nearest, so following level 0 stays within one cache line.
+        struct NodeBase
+        {
+            NodeBase* Prev = nullptr;
+            size_type Height = 0;
+        };
+
+        struct Node : NodeBase
+        {
+            value_type Value;
+
+            template <typename... Args>
+            explicit Node(Args&&... args):Value(std::forward<Args>(args)...)
+            {}
+        };
+
+#ifndef __cpp_aligned_new
+        static_assert(alignof(Node) <= alignof(std::max_align_t), "IndexedList needs aligned new (C++17) for over-aligned types!");
+#endif
+
+        NodeBase* Head;
+        NodeBase* End;
+        size_type Size;
+        std::uint32_t Seed;
+
+        static Link& linkOf(NodeBase* Current, size_type Level)
+        {
+            return reinterpret_cast<Link*>(Current)[-1 - static_cast<difference_type>(Level)];
+        }
+
+        static reference valueOf(NodeBase* Current)
+        {
+            return static_cast<Node*>(Current)->Value;
+        }
+
+        static NodeBase* endOf(NodeBase* Head)
+        {
+            return linkOf(Head, TopLevel).Next;
+        }
+
+        // Follows the tallest link of every node up to the end sentinel,
+        // which takes expected O(log n) steps.
+        static size_type rankOf(NodeBase* Head, NodeBase* Current)
+        {
+            NodeBase* Last = endOf(Head);
+            size_type Distance = 0;
+            while (Current != Last)
+            {
+                Link& Top = linkOf(Current, Current->Height - 1);
+                Distance += Top.Span;
+                Current = Top.Next;
+            }
+            return linkOf(Head, TopLevel).Span - Distance;
+        }
+
+        static NodeBase* nodeAt(NodeBase* Head, size_type Rank)
+        {
+            NodeBase* Current = Head;
+            size_type Reached = 0;
+            for (size_type Level = Head->Height; Level-- > 0;)
+                while (Reached < Rank && Reached + linkOf(Current, Level).Span <= Rank)
+                {
+                    Reached += linkOf(Current, Level).Span;
+                    Current = linkOf(Current, Level).Next;
+                }
+            return Current;
+        }
+
+        // For every level in use, the last node ranked below Rank and its rank.
+        void findPredecessors(size_type Rank, NodeBase** Update, size_type* Ranks) const
+        {
+            NodeBase* Current = Head;
+            size_type Reached = 0;
+            for (size_type Level = Head->Height; Level-- > 0;)
+            {
+                while (Reached + linkOf(Current, Level).Span < Rank)
+                {
+                    Reached += linkOf(Current, Level).Span;
+                    Current = linkOf(Current, Level).Next;
+                }
+                Update[Level] = Current;
+                Ranks[Level] = Reached;
+            }
+        }
+
+        // Geometric heights with p = 1/4 from a xorshift generator.
+        size_type randomHeight()
+        {
+            size_type Height = 1;
+            while (Height < MaxHeight)
+            {
+                Seed ^= Seed << 13;
+                Seed ^= Seed >> 17;
+                Seed ^= Seed << 5;
+                if ((Seed & 3) != 0)
+                    break;
+                Height++;
+            }
+            return Height;
+        }
+
+        // Bytes of links in front of a node of Height levels, padded so
+        // that the node behind them is aligned for Type.
+        static size_type linkBytes(size_type Height)
+        {
+            return (Height * sizeof(Link) + alignof(Node) - 1) / alignof(Node) * alignof(Node);
+        }
+
+        static void* allocateNode(size_type Bytes)
+        {
+#ifdef __cpp_aligned_new
+            if (alignof(Node) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+                return ::operator new(Bytes, std::align_val_t(alignof(Node)));
+#endif
+            return ::operator new(Bytes);
+        }
+
+        static void deallocateNode(void* Memory)
+        {
+#ifdef __cpp_aligned_new
+            if (alignof(Node) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+            {
+                ::operator delete(Memory, std::align_val_t(alignof(Node)));
+                return;
+            }
+#endif
+            ::operator delete(Memory);
+        }
+
+        template <typename... Args>
+        NodeBase* createNode(Args&&... args)
+        {
+            size_type Height = randomHeight();
+            char* Memory = static_cast<char*>(allocateNode(linkBytes(Height) + sizeof(Node)));
+            Node* NewNode;
+            try
+            {
+                NewNode = new (Memory + linkBytes(Height)) Node(std::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                deallocateNode(Memory);
+                throw;
+            }
+            NewNode->Height = Height;
+            return NewNode;
+        }
+
+        void destroyNode(NodeBase* Dead)
+        {
+            char* Memory = reinterpret_cast<char*>(Dead) - linkBytes(Dead->Height);
+            static_cast<Node*>(Dead)->~Node();
+            deallocateNode(Memory);
+        }
+
+        static NodeBase* createSentinel(size_type Links)
+        {
+            char* Memory = static_cast<char*>(::operator new(Links * sizeof(Link) + sizeof(NodeBase)));
+            return new (Memory + Links * sizeof(Link)) NodeBase;
+        }
+
+        static void destroySentinel(NodeBase* Sentinel, size_type Links)
+        {
+            ::operator delete(reinterpret_cast<char*>(Sentinel) - Links * sizeof(Link));
+        }
+
+        // Links NewNode right after Update[0]. Afterwards Update and Ranks
+        // describe the predecessors of the position just behind NewNode, so
+        // consecutive calls insert a run in order.
+        void linkNode(NodeBase* NewNode, NodeBase** Update, size_type* Ranks)
+        {
+            NewNode->Prev = Update[0];
+            size_type Height = NewNode->Height;
+            for (size_type Level = Head->Height; Level < Height; ++Level)
+            {
+                linkOf(Head, Level).Next = End;
+                linkOf(Head, Level).Span = Size + 1;
+                Update[Level] = Head;
+                Ranks[Level] = 0;
+            }
+            if (Height > Head->Height)
+                Head->Height = Height;
+
+            size_type Rank = Ranks[0] + 1;
+            for (size_type Level = 0; Level < Height; ++Level)
+            {
+                Link& Before = linkOf(Update[Level], Level);
+                linkOf(NewNode, Level).Next = Before.Next;
+                linkOf(NewNode, Level).Span = Before.Span - (Rank - 1 - Ranks[Level]);
+                Before.Next = NewNode;
+                Before.Span = Rank - Ranks[Level];
+                Update[Level] = NewNode;
+                Ranks[Level] = Rank;
+            }
+            for (size_type Level = Height; Level < Head->Height; ++Level)
+                linkOf(Update[Level], Level).Span++;
+
+            linkOf(NewNode, 0).Next->Prev = NewNode;
+            linkOf(Head, TopLevel).Span++;
+            Size++;
+        }
+
+        // Unlinks the node right after Update[0]; Update stays valid for the
+        // node that takes its place.
+        NodeBase* unlinkNext(NodeBase** Update)
+        {
+            NodeBase* Dead = linkOf(Update[0], 0).Next;
+            for (size_type Level = 0; Level < Head->Height; ++Level)
+            {
+                Link& Before = linkOf(Update[Level], Level);
+                if (Before.Next == Dead)
+                {
+                    Before.Span += linkOf(Dead, Level).Span - 1;
+                    Before.Next = linkOf(Dead, Level).Next;
+                }
+                else
+                    Before.Span--;
+            }
+            linkOf(Dead, 0).Next->Prev = Update[0];
+            linkOf(Head, TopLevel).Span--;
+            Size--;
+            return Dead;
+        }
+
+        void shrinkLevels()
+        {
+            while (Head->Height > 1 && linkOf(Head, Head->Height - 1).Next == End)
+                Head->Height--;
+        }
+
+        template <typename... Args>
+        NodeBase* emplaceAtRank(size_type Rank, Args&&... args)
+        {
+            NodeBase* Update[MaxHeight] = {};
+            size_type Ranks[MaxHeight];
+            findPredecessors(Rank, Update, Ranks);
+            NodeBase* NewNode = createNode(std::forward<Args>(args)...);
+            linkNode(NewNode, Update, Ranks);
+            return NewNode;
+        }
+
+        template <typename InputIt>
+        void insertRange(size_type Rank, InputIt first, InputIt last)
+        {
+            NodeBase* Update[MaxHeight] = {};
+            size_type Ranks[MaxHeight];
+            findPredecessors(Rank, Update, Ranks);
+            for (; first != last; ++first)
+            {
+                linkNode(createNode(*first), Update, Ranks);
+            }
+        }
+
+        void eraseRanks(size_type Rank, NodeBase* Stop)
+        {
+            NodeBase* Update[MaxHeight] = {};
+            size_type Ranks[MaxHeight];
+            findPredecessors(Rank, Update, Ranks);
+            while (linkOf(Update[0], 0).Next != Stop)
+                destroyNode(unlinkNext(Update));
+            shrinkLevels();
+        }
+
+        size_type checkedRank(size_type index, size_type limit) const
+        {
+            if (index >= limit)
+                throw std::out_of_range("Index out of range!");
+            return index + 1;
+        }
+
+        template <typename InputIt>
+        using RequireInputIterator = typename std::enable_if<std::is_convertible<
+                typename std::iterator_traits<InputIt>::iterator_category, std::input_iterator_tag>::value>::type;
+
+public:
+        IndexedList()
+        {
+            End = createSentinel(1);
+            Head = createSentinel(MaxHeight + 1);
+            Head->Height = 1;
+            linkOf(End, 0).Next = nullptr;
+            linkOf(Head, 0).Next = linkOf(Head, TopLevel).Next = End;
+            linkOf(Head, 0).Span = linkOf(Head, TopLevel).Span = 1;
+            End->Prev = Head;
+            Size = 0;
+            Seed = 0x9E3779B9u;
+        }
+
+        IndexedList(std::initializer_list<Type> l):IndexedList()
+        {
+            append(l.begin(), l.end());
+        }
+
+        template <typename InputIt, typename = RequireInputIterator<InputIt>>
+        IndexedList(InputIt first, InputIt last):IndexedList()
+        {
+            append(first, last);
+        }
+
+        IndexedList(const IndexedList& other):IndexedList()
+        {
+            *this = other;
+        }
+
+        IndexedList(IndexedList&& other):IndexedList()
+        {
+            *this = std::move(other);
+        }
+
+        ~IndexedList()
+        {
+            NodeBase* Current = linkOf(Head, 0).Next;
+            while (Current != End)
+            {
+                NodeBase* Next = linkOf(Current, 0).Next;
+                destroyNode(Current);
+                Current = Next;
+            }
+            destroySentinel(Head, MaxHeight + 1);
+            destroySentinel(End, 1);
+        }
+
+        IndexedList& operator=(const IndexedList& other)
+        {
+            if (this == &other)
+                return *this;
+
+            assign(other.begin(), other.end());
+
+            return *this;
+        }
+
+        // The sentinels travel with the nodes, so iterators into other keep
+        // working on this list.
+        IndexedList& operator=(IndexedList&& other)
+        {
+            if (this == &other)
+                return *this;
+
+            erase(begin(), end());
+            std::swap(Head, other.Head);
+            std::swap(End, other.End);
+            std::swap(Size, other.Size);
+
+            return *this;
+        }
+
+        bool isEmpty() const
+        {
+            return Size == 0;
+        }
+
+        size_type getSize() const
+        {
+            return Size;
+        }
+
+        // Bytes held by the list, its sentinels and its nodes; walks the list.
+        size_type getMemoryUsage() const
+        {
+            size_type Bytes = sizeof(IndexedList) + 2 * sizeof(NodeBase) + (MaxHeight + 2) * sizeof(Link);
+            for (NodeBase* Current = linkOf(Head, 0).Next; Current != End; Current = linkOf(Current, 0).Next)
+                Bytes += sizeof(Node) + linkBytes(Current->Height);
+            return Bytes;
+        }
+
+        reference at(size_type index)
+        {
+            return valueOf(nodeAt(Head, checkedRank(index, Size)));
+        }
+
+        const_reference at(size_type index) const
+        {
+            return valueOf(nodeAt(Head, checkedRank(index, Size)));
+        }
+
+        reference operator[](size_type index)
+        {
+            return valueOf(nodeAt(Head, index + 1));
+        }
+
+        const_reference operator[](size_type index) const
+        {
+            return valueOf(nodeAt(Head, index + 1));
+        }
+
+        // index == getSize() gives end().
+        iterator iteratorAt(size_type index)
+        {
+            return iterator(ConstIterator(nodeAt(Head, checkedRank(index, Size + 1)), Head));
+        }
+
+        const_iterator iteratorAt(size_type index) const
+        {
+            return ConstIterator(nodeAt(Head, checkedRank(index, Size + 1)), Head);
+        }
+
+        size_type indexOf(const const_iterator& position) const
+        {
+            return rankOf(Head, position.nodePointer) - 1;
+        }
+
+        void append(const Type& item)
+        {
+            emplaceAtRank(Size + 1, item);
+        }
+
+        void append(Type&& item)
+        {
+            emplaceAtRank(Size + 1, std::move(item));
+        }
+
+        template <typename InputIt, typename = RequireInputIterator<InputIt>>
+        void append(InputIt first, InputIt last)
+        {
+            insertRange(Size + 1, first, last);
+        }
+
+        void prepend(const Type& item)
+        {
+            emplaceAtRank(1, item);
+        }
+
+        void prepend(Type&& item)
+        {
+            emplaceAtRank(1, std::move(item));
+        }
+
+        void insert(const const_iterator& insertPosition, const Type& item)
+        {
+            emplace(insertPosition, item);
+        }
+
+        void insert(const const_iterator& insertPosition, Type&& item)
+        {
+            emplace(insertPosition, std::move(item));
+        }
+
+        template <typename InputIt, typename = RequireInputIterator<InputIt>>
+        void insert(const const_iterator& insertPosition, InputIt first, InputIt last)
+        {
+            insertRange(rankOf(Head, insertPosition.nodePointer), first, last);
+        }
+
+        void insertAt(size_type index, const Type& item)
+        {
+            emplaceAtRank(checkedRank(index, Size + 1), item);
+        }
+
+        void insertAt(size_type index, Type&& item)
+        {
+            emplaceAtRank(checkedRank(index, Size + 1), std::move(item));
+        }
+
+        template <typename InputIt, typename = RequireInputIterator<InputIt>>
+        void assign(InputIt first, InputIt last)
+        {
+            erase(begin(), end());
+            append(first, last);
+        }
+
+        void assign(std::initializer_list<Type> l)
+        {
+            assign(l.begin(), l.end());
+        }
+
+        template <typename... Args>
+        reference emplaceBack(Args&&... args)
+        {
+            return valueOf(emplaceAtRank(Size + 1, std::forward<Args>(args)...));
+        }
+
+        template <typename... Args>
+        reference emplaceFront(Args&&... args)
+        {
+            return valueOf(emplaceAtRank(1, std::forward<Args>(args)...));
+        }
+
+        template <typename... Args>
+        iterator emplace(const const_iterator& position, Args&&... args)
+        {
+            NodeBase* NewNode = emplaceAtRank(rankOf(Head, position.nodePointer), std::forward<Args>(args)...);
+            return iterator(ConstIterator(NewNode, Head));
+        }
+
+        Type popFirst()
+        {
+            if (Size == 0)
+                throw std::logic_error("No items to pop!");
+            auto Ret = std::move(valueOf(linkOf(Head, 0).Next));
+            eraseRanks(1, linkOf(linkOf(Head, 0).Next, 0).Next);
+            return Ret;
+        }
+
+        Type popLast()
+        {
+            if (Size == 0)
+                throw std::logic_error("No items to pop!");
+            auto Ret = std::move(valueOf(End->Prev));
+            eraseRanks(Size, End);
+            return Ret;
+        }
+
+        void erase(const const_iterator& possition)
+        {
+            if (possition == end())
+                throw std::out_of_range("Erasing end of list!");
+            eraseRanks(rankOf(Head, possition.nodePointer), linkOf(possition.nodePointer, 0).Next);
+        }
+
+        void erase(const const_iterator& firstIncluded, const const_iterator& lastExcluded)
+        {
+            if (firstIncluded == lastExcluded)
+                return;
+            if (firstIncluded == end())
+                throw std::out_of_range("Erasing end of list!");
+            eraseRanks(rankOf(Head, firstIncluded.nodePointer), lastExcluded.nodePointer);
+        }
+
+        void eraseAt(size_type index)
+        {
+            size_type Rank = checkedRank(index, Size);
+            eraseRanks(Rank, linkOf(nodeAt(Head, Rank), 0).Next);
+        }
+
+        iterator begin()
+        {
+            return iterator(cbegin());
+        }
+
+        iterator end()
+        {
+            return iterator(cend());
+        }
+
+        const_iterator cbegin() const
+        {
+            return ConstIterator(linkOf(Head, 0).Next, Head);
+        }
+
+        const_iterator cend() const
+        {
+            return ConstIterator(End, Head);
+        }
+
+        const_iterator begin() const
+        {
+            return cbegin();
+        }
+
+        const_iterator end() const
+        {
+            return cend();
+        }
+    };
+
+    template <typename Type>
+    class IndexedList<Type>::ConstIterator
+    {
+    public:
+        friend class IndexedList;
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = typename IndexedList::value_type;
+        using difference_type = typename IndexedList::difference_type;
+        using pointer = typename IndexedList::const_pointer;
+        using reference = typename IndexedList::const_reference;
+
+    private:
+        // The head sentinel lets + and - jump through the skip list; it
+        // moves together with the nodes when a list is moved.
+        NodeBase* nodePointer;
+        NodeBase* head;
+
+    public:
+        explicit ConstIterator(NodeBase* nodePointer_ = nullptr, NodeBase* head_ = nullptr)
+        {
+            nodePointer = nodePointer_;
+            head = head_;
+        }
+
+        reference operator*() const
+        {
+#if AISDI_CHECKED_ITERATORS
+            if (nodePointer == endOf(head))
+                throw std::out_of_range("Dereferencing end of list!");
+#endif
+            return valueOf(nodePointer);
+        }
+
+        pointer operator->() const
+        {
+            return &**this;
+        }
+
+        ConstIterator& operator++()
+        {
+#if AISDI_CHECKED_ITERATORS
+            if (nodePointer == endOf(head))
+                throw std::out_of_range("Incrementing end of list!");
+#endif
+            nodePointer = linkOf(nodePointer, 0).Next;
+            return *this;
+        }
+
+        ConstIterator operator++(int)
+        {
+            auto Ret = *this;
+            operator++();
+            return Ret;
+        }
+
+        ConstIterator& operator--()
+        {
+#if AISDI_CHECKED_ITERATORS
+            if (nodePointer->Prev == head)
+                throw std::out_of_range("Decrementing begin of list!");
+#endif
+            nodePointer = nodePointer->Prev;
+            return *this;
+        }
+
+        ConstIterator operator--(int)
+        {
+            auto Ret = *this;
+            operator--();
+            return Ret;
+        }
+
+        // Expected O(log n) for any distance.
+        ConstIterator operator+(difference_type d) const
+        {
+            size_type Rank = rankOf(head, nodePointer) + d;
+#if AISDI_CHECKED_ITERATORS
+            if (Rank < 1 || Rank > linkOf(head, TopLevel).Span)
+                throw std::out_of_range("Moving iterator outside of list!");
+#endif
+            return ConstIterator(nodeAt(head, Rank), head);
+        }
+
+        ConstIterator operator-(difference_type d) const
+        {
+            return *this + (-d);
+        }
+
+        difference_type operator-(const ConstIterator& other) const
+        {
+            return static_cast<difference_type>(rankOf(head, nodePointer)) - static_cast<difference_type>(rankOf(head, other.nodePointer));
+        }
+
+        bool operator==(const ConstIterator& other) const
+        {
+            return nodePointer == other.nodePointer;
+        }
+
+        bool operator!=(const ConstIterator& other) const
+        {
+            return nodePointer != other.nodePointer;
+        }
+    };
+
+    template <typename Type>
+    class IndexedList<Type>::Iterator : public IndexedList<Type>::ConstIterator
+    {
+    public:
+        using pointer = typename IndexedList::pointer;
+        using reference = typename IndexedList::reference;
+
+        explicit Iterator()
+        {}
+
+        Iterator(const ConstIterator& other)
+                : ConstIterator(other)
+        {}
+
+        Iterator& operator++()
+        {
+            ConstIterator::operator++();
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            auto result = *this;
+            ConstIterator::operator++();
+            return result;
+        }
+
+        Iterator& operator--()
+        {
+            ConstIterator::operator--();
+            return *this;
+        }
+
+        Iterator operator--(int)
+        {
+            auto result = *this;
+            ConstIterator::operator--();
+            return result;
+        }
+
+        Iterator operator+(difference_type d) const
+        {
+            return ConstIterator::operator+(d);
+        }
+
+        Iterator operator-(difference_type d) const
+        {
+            return ConstIterator::operator-(d);
+        }
+
+        using ConstIterator::operator-;
+
+        reference operator*() const
+        {
+            // ugly cast, yet reduces code duplication.
+            return const_cast<reference>(ConstIterator::operator*());
+        }
+
+        pointer operator->() const
+        {
+            return &**this;
+        }
+    };
+
+}
+
+#endif // AISDI_LINEAR_INDEXEDLIST_H
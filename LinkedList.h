@@ -1,16 +1,31 @@
 #ifndef AISDI_LINEAR_LINKEDLIST_H
 #define AISDI_LINEAR_LINKEDLIST_H
 
+#include <climits>
 #include <cstddef>
+#include <functional>
 #include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "Allocator.h"
+#include "Config.h"
+#include "NodePool.h"
+#include "Stats.h"
 
 namespace aisdi
 {
 
-    template <typename Type>
-    class LinkedList
+    template <typename Type, template <typename, typename> class NodeStorage = NodePool,
+              typename Allocator = std::allocator<Type>>
+    class LinkedList : private StatsRecorder<StatsFamily::LinkedList>
     {
+        static_assert(std::is_same<typename Allocator::value_type, Type>::value, "The allocator has to allocate the element type!");
+
 public:
         using difference_type = std::ptrdiff_t;
         using size_type = std::size_t;
@@ -19,6 +34,7 @@ public:
         using reference = Type&;
         using const_pointer = const Type*;
         using const_reference = const Type&;
+        using allocator_type = Allocator;
 
         class ConstIterator;
         class Iterator;
@@ -27,48 +43,340 @@ public:
 
 
 private:
+        // Value is built and destroyed by the list through the allocator,
+        // so elements that take an allocator get it too. The sentinel has
+        // none.
         struct Node
         {
             Node* Next = nullptr;
             Node* Prev = nullptr;
-            value_type Value;
+            union
+            {
+                value_type Value;
+            };
 
+            Node()
+            {}
 
+            ~Node()
+            {}
         };
 
+        using Traits = std::allocator_traits<Allocator>;
+        using Propagation = AllocatorPropagation<Allocator>;
+        using Recorder = StatsRecorder<StatsFamily::LinkedList>;
+
+        NodeStorage<Node, Allocator> Pool;
         size_type Size;
         Node* Head;
         Node* Tail;
 
+        Node* createSentinel()
+        {
+            Node* NewNode = new (Pool.allocate()) Node();
+            this->recordAllocation(sizeof(Node));
+            return NewNode;
+        }
+
+        template <typename... Args>
+        Node* createNode(Args&&... args)
+        {
+            Node* NewNode = createSentinel();
+            try
+            {
+                Traits::construct(Pool.allocator(), std::addressof(NewNode->Value), std::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                destroySentinel(NewNode);
+                throw;
+            }
+            return NewNode;
+        }
+
+        template <typename InputIt>
+        using RequireInputIterator = typename std::enable_if<std::is_convertible<
+                typename std::iterator_traits<InputIt>::iterator_category, std::input_iterator_tag>::value>::type;
+
+        // Links the detached chain First..Last of Count nodes in front of
+        // Position (which may be the sentinel).
+        void linkChain(Node* Position, Node* First, Node* Last, size_type Count)
+        {
+            First->Prev = Position->Prev;
+            Last->Next = Position;
+            if (Position == Head)
+                Head = First;
+            else
+                Position->Prev->Next = First;
+            Position->Prev = Last;
+            Size += Count;
+            this->recordCapacity(Size);
+        }
+
+        // Detaches the chain First..Last of Count nodes (Last is not the
+        // sentinel) and leaves its outer links null.
+        void unlinkChain(Node* First, Node* Last, size_type Count)
+        {
+            Last->Next->Prev = First->Prev;
+            if (First == Head)
+                Head = Last->Next;
+            else
+                First->Prev->Next = Last->Next;
+            First->Prev = nullptr;
+            Last->Next = nullptr;
+            Size -= Count;
+        }
+
+        // Number of nodes from Position up to the sentinel. Walks out from
+        // Position in both directions, so it costs O(min(k, n - k)).
+        size_type countToEnd(Node* Position) const
+        {
+            Node* Forward = Position;
+            Node* Backward = Position;
+            size_type Steps = 0;
+            while (Forward != Tail && Backward != Head)
+            {
+                Forward = Forward->Next;
+                Backward = Backward->Prev;
+                Steps++;
+            }
+            return Forward == Tail ? Steps : Size - Steps;
+        }
+
+        // Links a node built from args in front of Position; the value is
+        // constructed in place exactly once.
+        template <typename... Args>
+        Node* emplaceBefore(Node* Position, Args&&... args)
+        {
+            Node* NewNode = createNode(std::forward<Args>(args)...);
+            linkChain(Position, NewNode, NewNode, 1);
+            return NewNode;
+        }
+
+        // Builds every node of the range into a detached chain first, so the
+        // list is touched once and is left unchanged if a copy throws.
+        template <typename InputIt>
+        void insertChain(Node* Position, InputIt first, InputIt last)
+        {
+            if (first == last)
+                return;
+            Node* First = createNode(*first);
+            Node* Last = First;
+            size_type Count = 1;
+            try
+            {
+                for (++first; first != last; ++first)
+                {
+                    Node* NewNode = createNode(*first);
+                    NewNode->Prev = Last;
+                    Last->Next = NewNode;
+                    Last = NewNode;
+                    Count++;
+                }
+            }
+            catch (...)
+            {
+                while (First != nullptr)
+                {
+                    auto Temp = First;
+                    First = First->Next;
+                    destroyNode(Temp);
+                }
+                throw;
+            }
+            linkChain(Position, First, Last, Count);
+        }
+
+        void destroySentinel(Node* Dead)
+        {
+            Dead->~Node();
+            Pool.deallocate(Dead);
+            this->recordFree(sizeof(Node));
+        }
+
+        void destroyNode(Node* Dead)
+        {
+            Traits::destroy(Pool.allocator(), std::addressof(Dead->Value));
+            destroySentinel(Dead);
+        }
+
+        // Merges the sorted chain Second into the sorted chain First; both
+        // are linked through Next and end in null. Of equal elements, those
+        // of First come first. If comp throws, First is left holding every
+        // node of both, out of order.
+        template <typename Compare>
+        static void mergeChains(Node*& First, Node* Second, Compare& comp)
+        {
+            Node* Merged = nullptr;
+            Node** Link = &Merged;
+            Node* Rest = First;
+            try
+            {
+                while (Rest != nullptr && Second != nullptr)
+                {
+                    if (comp(Second->Value, Rest->Value))
+                    {
+                        *Link = Second;
+                        Second = Second->Next;
+                    }
+                    else
+                    {
+                        *Link = Rest;
+                        Rest = Rest->Next;
+                    }
+                    Link = &(*Link)->Next;
+                }
+            }
+            catch (...)
+            {
+                for (*Link = Rest; *Link != nullptr; Link = &(*Link)->Next)
+                {}
+                *Link = Second;
+                First = Merged;
+                throw;
+            }
+            *Link = Rest != nullptr ? Rest : Second;
+            First = Merged;
+        }
+
+        // Links the chain First, of Count nodes joined only through Next,
+        // to the end of the list.
+        void appendChain(Node* First, size_type Count)
+        {
+            Node* Last = nullptr;
+            for (Node* Current = First; Current != nullptr; Current = Current->Next)
+            {
+                Current->Prev = Last;
+                Last = Current;
+            }
+            if (Last != nullptr)
+                linkChain(Tail, First, Last, Count);
+        }
+
+        // Gives back slots of Storage chained through their first word.
+        static void releaseSlots(NodeStorage<Node, Allocator>& Storage, void* Slots)
+        {
+            while (Slots != nullptr)
+            {
+                void* Next = *static_cast<void**>(Slots);
+                Storage.deallocate(Slots);
+                Slots = Next;
+            }
+        }
+
+        // Destroys a detached chain of nodes linked through Next.
+        void destroyChain(Node* First)
+        {
+            while (First != nullptr)
+            {
+                Node* Dead = First;
+                First = First->Next;
+                destroyNode(Dead);
+            }
+        }
+
+        // Nodes live in the pool that allocated them, so the pools travel
+        // with the nodes.
+        void swapNodes(LinkedList& other)
+        {
+            Pool.swap(other.Pool);
+            std::swap(Head, other.Head);
+            std::swap(Tail, other.Tail);
+            std::swap(Size, other.Size);
+        }
+
+        void swapWith(LinkedList& other, std::true_type)
+        {
+            swapNodes(other);
+            Propagation::swapOnSwap(Pool.allocator(), other.Pool.allocator());
+        }
+
+        // Equal allocators can free each other's nodes; otherwise the
+        // elements have to be moved across.
+        void swapWith(LinkedList& other, std::false_type)
+        {
+            if (Pool.allocator() == other.Pool.allocator())
+            {
+                swapNodes(other);
+                return;
+            }
+            LinkedList Temp(std::move(other));
+            other = std::move(*this);
+            *this = std::move(Temp);
+        }
+
+        // Relinking nodes into this list is only allowed when our allocator
+        // can free them.
+        void checkSharedAllocator(const LinkedList& other) const
+        {
+            if (!(Pool.allocator() == other.Pool.allocator()))
+                throw std::logic_error("Moving nodes between lists with different allocators!");
+        }
+
 public:
-        LinkedList()
+        LinkedList():LinkedList(Allocator())
+        {}
+
+        explicit LinkedList(const Allocator& allocator_):Pool(nullptr, allocator_)
         {
-            Head = Tail = new Node;
+            Head = Tail = createSentinel();
             Size = 0;
         }
 
-        LinkedList(std::initializer_list<Type> l):LinkedList()
+        explicit LinkedList(NodeArena& arena, const Allocator& allocator_ = Allocator()):Pool(&arena, allocator_)
+        {
+            Head = Tail = createSentinel();
+            Size = 0;
+        }
+
+        LinkedList(std::initializer_list<Type> l, const Allocator& allocator_ = Allocator()):LinkedList(allocator_)
         {
             for (auto it = l.begin(); it != l.end(); it++)
                 append (*it);
 
         }
 
-        LinkedList(const LinkedList& other):LinkedList()
+        template <typename InputIt, typename = RequireInputIterator<InputIt>>
+        LinkedList(InputIt first, InputIt last, const Allocator& allocator_ = Allocator()):LinkedList(allocator_)
+        {
+            append(first, last);
+        }
+
+        LinkedList(const LinkedList& other):LinkedList(Propagation::copyFor(other.Pool.allocator()))
+        {
+            this->recordCopies(other.Size);
+            assign(other.begin(), other.end());
+        }
+
+        LinkedList(const LinkedList& other, const Allocator& allocator_):LinkedList(allocator_)
+        {
+            this->recordCopies(other.Size);
+            assign(other.begin(), other.end());
+        }
+
+        LinkedList(LinkedList&& other):LinkedList(other.Pool.allocator())
         {
-            *this = other;
+            swapNodes(other);
         }
 
-        LinkedList(LinkedList&& other):LinkedList()
+        // Takes other's nodes when allocator_ can free them, otherwise moves
+        // the elements into new nodes.
+        LinkedList(LinkedList&& other, const Allocator& allocator_):LinkedList(allocator_)
         {
-            *this = std::move(other);
+            if (Pool.allocator() == other.Pool.allocator())
+                swapNodes(other);
+            else
+            {
+                this->recordMoves(other.Size);
+                append(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+            }
         }
 
         ~LinkedList()
         {
             if (Size > 0)
                 erase (begin(), end());
-            delete Tail;
+            destroySentinel(Tail);
         }
 
         LinkedList& operator=(const LinkedList& other)
@@ -76,30 +384,58 @@ public:
             if (this == &other)
                 return *this;
 
-            erase (begin(), end());
-            for (auto it = other.begin(); it != other.end(); it++)
-                append (*it);
+            // A propagated allocator cannot free our nodes, so the copy is
+            // built with it and our nodes leave with Copy and our allocator.
+            if (Propagation::OnCopy::value && !(Pool.allocator() == other.Pool.allocator()))
+            {
+                LinkedList Copy(other, other.Pool.allocator());
+                swapNodes(Copy);
+                Propagation::swapOnCopy(Pool.allocator(), Copy.Pool.allocator());
+                return *this;
+            }
+            this->recordCopies(other.Size);
+            assign(other.begin(), other.end());
 
             return *this;
         }
 
+        // other is left with our (emptied) sentinel. With allocators that
+        // neither propagate nor compare equal, the elements are moved over.
         LinkedList& operator=(LinkedList&& other)
         {
             if (this == &other)
                 return *this;
 
-            Head = other.Head;
-            other.Head = nullptr;
+            if (!Propagation::canMove(Pool.allocator(), other.Pool.allocator()))
+            {
+                this->recordMoves(other.Size);
+                assign(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+                return *this;
+            }
+            erase (begin(), end());
+            swapNodes(other);
+            Propagation::swapOnMove(Pool.allocator(), other.Pool.allocator());
 
-            Tail = other.Tail;
-            other.Tail = nullptr;
+            return *this;
+        }
 
-            Size = other.Size;
-            other.Size = 0;
+        // O(1) unless the allocators neither propagate on swap nor compare
+        // equal; then the elements are moved across.
+        void swap(LinkedList& other)
+        {
+            if (this != &other)
+                swapWith(other, typename Propagation::OnSwap());
+        }
 
-            return *this;
+        allocator_type getAllocator() const
+        {
+            return Pool.allocator();
         }
 
+        // Zeros unless built with AISDI_STATS; see Stats.h.
+        using Recorder::getStats;
+        using Recorder::resetStats;
+
         bool isEmpty() const
         {
             if (Size == 0)
@@ -112,70 +448,97 @@ public:
             return Size;
         }
 
+        // Allocates the nodes of the next count inserts in one block, so a
+        // list built in one go is laid out in order.
+        void reserve(size_type count)
+        {
+            Pool.reserve(count);
+        }
+
         void append(const Type& item)
         {
-            Node* NewNode = new Node;
-            NewNode->Value = item;
-            if (Size == 0)
-            {
-                Head = NewNode;
-                Head->Next = Tail;
-                Tail->Prev = Head;
-            }
-            else
-            {
-                Tail->Prev->Next = NewNode;
-                NewNode->Prev = Tail->Prev;
-                Tail->Prev = NewNode;
-                NewNode->Next = Tail;
-            }
-            Size++;
+            emplaceBefore(Tail, item);
+        }
+
+        void append(Type&& item)
+        {
+            emplaceBefore(Tail, std::move(item));
+        }
+
+        template <typename InputIt, typename = RequireInputIterator<InputIt>>
+        void append(InputIt first, InputIt last)
+        {
+            insertChain(Tail, first, last);
         }
 
         void prepend(const Type& item)
         {
-            Node* NewNode = new Node;
-            NewNode->Value = item;
-            if (Size == 0)
-            {
-                Head = NewNode;
-                Head->Next = Tail;
-                Tail->Prev = Head;
-            }
-            else
-            {
-                NewNode->Next = Head;
-                Head->Prev = NewNode;
-                Head = NewNode;
-            }
-            Size++;
+            emplaceBefore(Head, item);
+        }
+
+        void prepend(Type&& item)
+        {
+            emplaceBefore(Head, std::move(item));
         }
 
         void insert(const const_iterator& insertPosition, const Type& item)
         {
-            if (insertPosition == begin())
-                prepend(item);
-            else if (insertPosition == end())
-                append(item);
+            emplaceBefore(insertPosition.nodePointer, item);
+        }
+
+        void insert(const const_iterator& insertPosition, Type&& item)
+        {
+            emplaceBefore(insertPosition.nodePointer, std::move(item));
+        }
+
+        template <typename InputIt, typename = RequireInputIterator<InputIt>>
+        void insert(const const_iterator& insertPosition, InputIt first, InputIt last)
+        {
+            insertChain(insertPosition.nodePointer, first, last);
+        }
+
+        // Reuses the existing nodes for the new values; only the difference
+        // in length is allocated or freed.
+        template <typename InputIt, typename = RequireInputIterator<InputIt>>
+        void assign(InputIt first, InputIt last)
+        {
+            Node* Current = Head;
+            for (; Current != Tail && first != last; ++first, Current = Current->Next)
+                Current->Value = *first;
+            if (first != last)
+                insertChain(Tail, first, last);
             else
-            {
-                Node* NewNode = new Node;
-                NewNode->Value = item;
+                erase(ConstIterator(Current), end());
+        }
 
-                NewNode->Next = insertPosition.nodePointer;
-                NewNode->Prev = insertPosition.nodePointer->Prev;
-                insertPosition.nodePointer->Prev->Next = NewNode;
-                insertPosition.nodePointer->Prev = NewNode;
+        void assign(std::initializer_list<Type> l)
+        {
+            assign(l.begin(), l.end());
+        }
 
-                Size++;
-            }
+        template <typename... Args>
+        reference emplaceBack(Args&&... args)
+        {
+            return emplaceBefore(Tail, std::forward<Args>(args)...)->Value;
+        }
+
+        template <typename... Args>
+        reference emplaceFront(Args&&... args)
+        {
+            return emplaceBefore(Head, std::forward<Args>(args)...)->Value;
+        }
+
+        template <typename... Args>
+        iterator emplace(const const_iterator& position, Args&&... args)
+        {
+            return iterator(ConstIterator(emplaceBefore(position.nodePointer, std::forward<Args>(args)...)));
         }
 
         Type popFirst()
         {
             if (Size == 0)
                 throw std::logic_error("No items to pop!");
-            auto Ret = Head->Value;
+            auto Ret = std::move(Head->Value);
             erase (begin());
             return Ret;
         }
@@ -184,7 +547,7 @@ public:
         {
             if (Size == 0)
                 throw std::logic_error("No items to pop!");
-            auto Ret = Tail->Prev->Value;
+            auto Ret = std::move(Tail->Prev->Value);
             erase (end()-1);
             return Ret;
         }
@@ -216,7 +579,7 @@ public:
                         {
                             auto Temp = First;
                             First = First->Next;
-                            delete Temp;
+                            destroyNode(Temp);
                             Size--;
                         }
                     }
@@ -229,13 +592,371 @@ public:
                         {
                             auto Temp = First;
                             First = First->Next;
-                            delete Temp;
+                            destroyNode(Temp);
                             Size--;
                         }
                 }
             }
         }
 
+        // Unlinks every node pred holds for in one pass and returns how many
+        // there were. The nodes are destroyed only after the pass, so pred
+        // may keep pointers to elements it has already seen.
+        template <typename Predicate>
+        size_type eraseIf(Predicate pred)
+        {
+            Node* Removed = nullptr;
+            size_type Count = 0;
+            try
+            {
+                for (Node* Current = Head; Current != Tail;)
+                {
+                    Node* Next = Current->Next;
+                    if (pred(Current->Value))
+                    {
+                        unlinkChain(Current, Current, 1);
+                        Current->Next = Removed;
+                        Removed = Current;
+                        Count++;
+                    }
+                    Current = Next;
+                }
+            }
+            catch (...)
+            {
+                destroyChain(Removed);
+                throw;
+            }
+            destroyChain(Removed);
+            return Count;
+        }
+
+        size_type remove(const Type& value)
+        {
+            return eraseIf([&value](const Type& item) { return item == value; });
+        }
+
+        // Keeps the first of every run of elements same holds for, compared
+        // with the last element kept.
+        template <typename BinaryPredicate>
+        size_type unique(BinaryPredicate same)
+        {
+            const Type* Kept = nullptr;
+            return eraseIf([&Kept, &same](const Type& item) {
+                if (Kept != nullptr && same(*Kept, item))
+                    return true;
+                Kept = &item;
+                return false;
+            });
+        }
+
+        size_type unique()
+        {
+            return unique([](const Type& first, const Type& second) { return first == second; });
+        }
+
+        // Moves every element of other in front of position by relinking
+        // nodes: nothing is allocated or copied, and iterators to the moved
+        // elements stay valid, now pointing into this list.
+        void splice(const const_iterator& position, LinkedList& other)
+        {
+            if (this == &other || other.Size == 0)
+                return;
+            checkSharedAllocator(other);
+            Node* First = other.Head;
+            Node* Last = other.Tail->Prev;
+            size_type Count = other.Size;
+            other.unlinkChain(First, Last, Count);
+            linkChain(position.nodePointer, First, Last, Count);
+        }
+
+        void splice(const const_iterator& position, LinkedList&& other)
+        {
+            splice(position, other);
+        }
+
+        // Moves [first, last) of other in front of position. The relinking
+        // is O(1); moving between two lists also counts the range so that
+        // both sizes stay exact. position must not lie inside the range.
+        void splice(const const_iterator& position, LinkedList& other,
+                    const const_iterator& first, const const_iterator& last)
+        {
+            if (first == last)
+                return;
+            if (first == other.end())
+                throw std::out_of_range("Splicing end of list!");
+            Node* First = first.nodePointer;
+            Node* Last = last.nodePointer->Prev;
+            if (this == &other)
+            {
+                if (position == first || position == last)
+                    return;
+                unlinkChain(First, Last, 0);
+                linkChain(position.nodePointer, First, Last, 0);
+                return;
+            }
+            size_type Count = 1;
+            for (Node* Current = First; Current != Last; Current = Current->Next)
+                Count++;
+            checkSharedAllocator(other);
+            other.unlinkChain(First, Last, Count);
+            linkChain(position.nodePointer, First, Last, Count);
+        }
+
+        void splice(const const_iterator& position, LinkedList&& other,
+                    const const_iterator& first, const const_iterator& last)
+        {
+            splice(position, other, first, last);
+        }
+
+        // Cuts the list in two: this keeps [begin, position) and the returned
+        // list takes [position, end) without copying any element.
+        LinkedList splitAt(const const_iterator& position)
+        {
+            LinkedList Rest(Pool.allocator());
+            if (position == end())
+                return Rest;
+            Node* First = position.nodePointer;
+            Node* Last = Tail->Prev;
+            size_type Count = countToEnd(First);
+            unlinkChain(First, Last, Count);
+            Rest.linkChain(Rest.Tail, First, Last, Count);
+            return Rest;
+        }
+
+        // Merges the sorted other into this sorted list by relinking runs of
+        // its nodes. Stable: of equal elements, those already here come
+        // first. other is left empty; if comp throws, the elements not yet
+        // merged are given back to other.
+        template <typename Compare>
+        void merge(LinkedList& other, Compare comp)
+        {
+            if (this == &other || other.Size == 0)
+                return;
+            checkSharedAllocator(other);
+            Node* Incoming = other.Head;
+            Node* IncomingLast = other.Tail->Prev;
+            size_type Remaining = other.Size;
+            other.unlinkChain(Incoming, IncomingLast, Remaining);
+
+            Node* Position = Head;
+            try
+            {
+                while (Incoming != nullptr)
+                {
+                    while (Position != Tail && !comp(Incoming->Value, Position->Value))
+                        Position = Position->Next;
+                    if (Position == Tail)
+                    {
+                        linkChain(Tail, Incoming, IncomingLast, Remaining);
+                        return;
+                    }
+                    Node* RunLast = Incoming;
+                    size_type Run = 1;
+                    while (RunLast->Next != nullptr && comp(RunLast->Next->Value, Position->Value))
+                    {
+                        RunLast = RunLast->Next;
+                        Run++;
+                    }
+                    Node* Next = RunLast->Next;
+                    RunLast->Next = nullptr;
+                    linkChain(Position, Incoming, RunLast, Run);
+                    Incoming = Next;
+                    Remaining -= Run;
+                }
+            }
+            catch (...)
+            {
+                other.linkChain(other.Tail, Incoming, IncomingLast, Remaining);
+                throw;
+            }
+        }
+
+        void merge(LinkedList& other)
+        {
+            merge(other, std::less<Type>());
+        }
+
+        void merge(LinkedList&& other)
+        {
+            merge(other);
+        }
+
+        // Stable bottom-up merge sort that relinks nodes: nothing is
+        // allocated, copied or moved, and iterators keep pointing at the same
+        // elements. Bins[k] holds a sorted run of 2^k nodes; each node taken
+        // from the list carries into the bins like a binary counter. If comp
+        // throws, every element stays in the list, in no particular order.
+        template <typename Compare>
+        void sort(Compare comp)
+        {
+            if (Size < 2)
+                return;
+            size_type Count = Size;
+            Node* Input = Head;
+            unlinkChain(Head, Tail->Prev, Count);
+            Node* Bins[sizeof(size_type) * CHAR_BIT] = {};
+            size_type Used = 0;
+            Node* Sorted = nullptr;
+            try
+            {
+                while (Input != nullptr)
+                {
+                    Node* Run = Input;
+                    Input = Input->Next;
+                    Run->Next = nullptr;
+                    size_type Bin = 0;
+                    for (; Bin < Used && Bins[Bin] != nullptr; Bin++)
+                    {
+                        mergeChains(Bins[Bin], Run, comp);
+                        Run = Bins[Bin];
+                        Bins[Bin] = nullptr;
+                    }
+                    Bins[Bin] = Run;
+                    if (Bin == Used)
+                        Used++;
+                }
+                // Higher bins hold earlier elements, so they go first.
+                for (size_type Bin = 0; Bin < Used; Bin++)
+                    if (Bins[Bin] != nullptr)
+                    {
+                        Node* Later = Sorted;
+                        Sorted = nullptr;
+                        mergeChains(Bins[Bin], Later, comp);
+                        Sorted = Bins[Bin];
+                        Bins[Bin] = nullptr;
+                    }
+            }
+            catch (...)
+            {
+                Node* Rest = Input;
+                for (Node* Chain : Bins)
+                    if (Chain != nullptr)
+                    {
+                        Node* Last = Chain;
+                        while (Last->Next != nullptr)
+                            Last = Last->Next;
+                        Last->Next = Rest;
+                        Rest = Chain;
+                    }
+                appendChain(Rest, Count);
+                throw;
+            }
+            appendChain(Sorted, Count);
+        }
+
+        void sort()
+        {
+            sort(std::less<Type>());
+        }
+
+        // Moves the elements, in order, into new nodes taken from one block
+        // of a new node storage, frees the old nodes and drops the old
+        // storage. A list scattered by insert/erase churn is scanned through
+        // memory front to back again. Elements are moved when that cannot
+        // throw and copied otherwise, so on failure the list is left as it
+        // was. Invalidates every iterator.
+        //
+        // The block comes from the allocator even when the list has an arena:
+        // arena memory is never given back, so every compact would use up
+        // another list's worth of it until the arena ran dry. Nodes added
+        // later still come from the arena while it lasts.
+        void compact()
+        {
+            NodeStorage<Node, Allocator> Fresh(nullptr, Pool.allocator());
+            Fresh.reserve(Size + 1);
+            // All the slots are taken first, chained through their first
+            // word in list order, so running out of memory moves nothing.
+            void* Slots = nullptr;
+            void** Link = &Slots;
+            try
+            {
+                for (size_type i = 0; i <= Size; i++)
+                {
+                    void* Slot = Fresh.allocate();
+                    *Link = Slot;
+                    Link = new (Slot) void*(nullptr);
+                }
+            }
+            catch (...)
+            {
+                releaseSlots(Fresh, Slots);
+                throw;
+            }
+            // With nothing left that can throw, each old node is freed as the
+            // pass leaves it rather than in a second walk over scattered nodes.
+            // What counts is the allocator's construct, which for allocator-
+            // aware types such as pmr strings may throw where a plain move
+            // would not.
+            const bool FreeAsMoved = noexcept(Traits::construct(std::declval<Allocator&>(), std::declval<Type*>(),
+                                                                std::move_if_noexcept(std::declval<Type&>())));
+            Node* First = nullptr;
+            Node* Last = nullptr;
+            try
+            {
+                Node* Current = Head;
+                while (Current != Tail)
+                {
+                    void* Slot = Slots;
+                    Slots = *static_cast<void**>(Slot);
+                    Node* NewNode = new (Slot) Node();
+                    try
+                    {
+                        Traits::construct(Pool.allocator(), std::addressof(NewNode->Value), std::move_if_noexcept(Current->Value));
+                    }
+                    catch (...)
+                    {
+                        NewNode->~Node();
+                        Fresh.deallocate(NewNode);
+                        throw;
+                    }
+                    NewNode->Prev = Last;
+                    if (Last == nullptr)
+                        First = NewNode;
+                    else
+                        Last->Next = NewNode;
+                    Last = NewNode;
+                    Node* Next = Current->Next;
+                    if (FreeAsMoved)
+                        destroyNode(Current);
+                    Current = Next;
+                }
+            }
+            catch (...)
+            {
+                while (First != nullptr)
+                {
+                    Node* Dead = First;
+                    First = First->Next;
+                    Traits::destroy(Pool.allocator(), std::addressof(Dead->Value));
+                    Dead->~Node();
+                    Fresh.deallocate(Dead);
+                }
+                releaseSlots(Fresh, Slots);
+                throw;
+            }
+            Node* NewTail = new (Slots) Node();
+            NewTail->Prev = Last;
+            if (Last == nullptr)
+                First = NewTail;
+            else
+                Last->Next = NewTail;
+            for (size_type i = 0; i <= Size; i++)
+                this->recordAllocation(sizeof(Node));
+            Node* Old = FreeAsMoved ? Tail : Head;
+            while (Old != Tail)
+            {
+                Node* Dead = Old;
+                Old = Old->Next;
+                destroyNode(Dead);
+            }
+            destroySentinel(Tail);
+            Head = First;
+            Tail = NewTail;
+            Pool.swap(Fresh);
+            Pool.setArena(Fresh.getArena());
+        }
+
         iterator begin()
         {
             return iterator (cbegin());
@@ -248,12 +969,12 @@ public:
 
         const_iterator cbegin() const
         {
-            return ConstIterator(Head, Head, Tail);
+            return ConstIterator(Head);
         }
 
         const_iterator cend() const
         {
-            return ConstIterator(Tail, Head, Tail);
+            return ConstIterator(Tail);
         }
 
         const_iterator begin() const
@@ -267,8 +988,8 @@ public:
         }
     };
 
-    template <typename Type>
-    class LinkedList<Type>::ConstIterator
+    template <typename Type, template <typename, typename> class NodeStorage, typename Allocator>
+    class LinkedList<Type, NodeStorage, Allocator>::ConstIterator
     {
     public:
         friend class LinkedList;
@@ -279,31 +1000,36 @@ public:
         using reference = typename LinkedList::const_reference;
 
     private:
+        // The sentinel is the only node without a successor and the head
+        // the only one without a predecessor, so checks need no list state.
         Node *nodePointer;
-        Node *head;
-        Node *tail;
 
     public:
-        explicit ConstIterator(Node* nodePointer_, Node* head_, Node* tail_)
+        explicit ConstIterator(Node* nodePointer_ = nullptr)
         {
             nodePointer = nodePointer_;
-            head = head_;
-            tail = tail_;
         }
 
 
         reference operator*() const
         {
-            if (nodePointer == tail)
+#if AISDI_CHECKED_ITERATORS
+            if (nodePointer->Next == nullptr)
                 throw std::out_of_range("Dereferencing end of list!");
+#endif
             return nodePointer->Value;
         }
 
         ConstIterator& operator++()
         {
-            if (nodePointer == tail)
+#if AISDI_CHECKED_ITERATORS
+            if (nodePointer->Next == nullptr)
                 throw std::out_of_range("Incrementing end of list!");
+#endif
             nodePointer = nodePointer->Next;
+#if AISDI_PREFETCH && (defined(__GNUC__) || defined(__clang__))
+            __builtin_prefetch(nodePointer->Next);
+#endif
             return *this;
         }
 
@@ -316,8 +1042,10 @@ public:
 
         ConstIterator& operator--()
         {
-            if (nodePointer == head)
+#if AISDI_CHECKED_ITERATORS
+            if (nodePointer->Prev == nullptr)
                 throw std::out_of_range("Decrementing begin of list!");
+#endif
             nodePointer = nodePointer->Prev;
             return *this;
         }
@@ -369,8 +1097,8 @@ public:
         }
     };
 
-    template <typename Type>
-    class LinkedList<Type>::Iterator : public LinkedList<Type>::ConstIterator
+    template <typename Type, template <typename, typename> class NodeStorage, typename Allocator>
+    class LinkedList<Type, NodeStorage, Allocator>::Iterator : public LinkedList<Type, NodeStorage, Allocator>::ConstIterator
     {
     public:
         using pointer = typename LinkedList::pointer;
@@ -426,6 +1154,22 @@ public:
         }
     };
 
+    template <typename Type, template <typename, typename> class NodeStorage, typename Allocator>
+    void swap(LinkedList<Type, NodeStorage, Allocator>& first, LinkedList<Type, NodeStorage, Allocator>& second)
+    {
+        first.swap(second);
+    }
+
+#if AISDI_PMR
+    // Lists whose node chunks, and the allocations of elements that take an
+    // allocator, come from a std::pmr::memory_resource.
+    namespace pmr
+    {
+        template <typename Type, template <typename, typename> class NodeStorage = NodePool>
+        using LinkedList = aisdi::LinkedList<Type, NodeStorage, std::pmr::polymorphic_allocator<Type>>;
+    }
+#endif
+
 }
 
 #endif // AISDI_LINEAR_LINKEDLIST_H
@@ -0,0 +1,734 @@
+#ifndef AISDI_LINEAR_MAPPEDVECTOR_H
+#define AISDI_LINEAR_MAPPEDVECTOR_H
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Config.h"
+#include "Vector.h"
+
+namespace aisdi
+{
+
+    enum class MapMode
+    {
+        ReadWrite,
+        ReadOnly
+    };
+
+    // A Vector of plain records that lives in a file mapped into memory
+    // (POSIX only). Opening an existing file maps it without reading it;
+    // pages are loaded when first touched, so startup costs the same for
+    // any size and the data may be larger than RAM. Growing extends the
+    // file with ftruncate and maps it again, which moves the elements'
+    // addresses like a Vector reallocation does.
+    //
+    // The file starts with a small header holding the element size and
+    // count, followed by the elements. Mappings are shared: stores reach
+    // the file through the page cache, and flush() waits until they are on
+    // disk. Any number of processes may open the file ReadOnly; they see
+    // the element count as of opening and must not run alongside a writer
+    // that shrinks or replaces the file. Writing through a ReadOnly vector
+    // throws, except through data() and iterators, which fault.
+    //
+    // prepend, popFirst and middle inserts shift the elements behind them;
+    // unlike Vector there is no front room.
+    template <typename Type, typename GrowthPolicy = DoublingGrowth>
+    class MappedVector
+    {
+        static_assert(std::is_trivially_copyable<Type>::value, "MappedVector stores elements as raw bytes, they have to be trivially copyable!");
+
+    public:
+        using difference_type = std::ptrdiff_t;
+        using size_type = std::size_t;
+        using value_type = Type;
+        using pointer = Type*;
+        using reference = Type&;
+        using const_pointer = const Type*;
+        using const_reference = const Type&;
+
+        class ConstIterator;
+        class Iterator;
+        using iterator = Iterator;
+        using const_iterator = ConstIterator;
+
+    private:
+        struct Header
+        {
+            char magic[8];
+            std::uint64_t elementSize;
+            std::uint64_t size;
+        };
+
+        // Elements start one cache line into the file, so they are as
+        // aligned as the page-aligned mapping allows.
+        static const size_type HeaderBytes = 64;
+        static_assert(alignof(Type) <= HeaderBytes, "MappedVector cannot align elements beyond 64 bytes!");
+
+        int file = -1;
+        bool readOnly = false;
+        unsigned char* mapping = nullptr;
+        size_type mappedBytes = 0;
+        size_type current_size = 0;
+        size_type capacity = 0;
+
+        static const char* magic()
+        {
+            return "AISDIMV1";
+        }
+
+        [[noreturn]] static void fail(const std::string& what)
+        {
+            throw std::system_error(errno, std::generic_category(), what);
+        }
+
+        Header* header() const
+        {
+            return reinterpret_cast<Header*>(mapping);
+        }
+
+        pointer elements() const
+        {
+            return reinterpret_cast<pointer>(mapping + HeaderBytes);
+        }
+
+        static size_type fileBytes(size_type count)
+        {
+            if (count > (std::numeric_limits<size_type>::max() - HeaderBytes) / sizeof(value_type))
+                throw std::length_error("MappedVector is too large!");
+            return HeaderBytes + count * sizeof(value_type);
+        }
+
+        unsigned char* map(size_type bytes) const
+        {
+            void* memory = ::mmap(nullptr, bytes, readOnly ? PROT_READ : PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+            if (memory == MAP_FAILED)
+                fail("Cannot map the vector's file");
+            return static_cast<unsigned char*>(memory);
+        }
+
+        void release()
+        {
+            if (mapping != nullptr)
+                ::munmap(mapping, mappedBytes);
+            if (file >= 0)
+                ::close(file);
+            mapping = nullptr;
+            file = -1;
+        }
+
+        void openMapping(const std::string& path)
+        {
+            struct stat status;
+            if (::fstat(file, &status) != 0)
+                fail("Cannot stat " + path);
+            size_type bytes = static_cast<size_type>(status.st_size);
+            if (bytes == 0 && !readOnly)
+            {
+                if (::ftruncate(file, HeaderBytes) != 0)
+                    fail("Cannot extend " + path);
+                mapping = map(HeaderBytes);
+                mappedBytes = HeaderBytes;
+                std::memcpy(header()->magic, magic(), sizeof(header()->magic));
+                header()->elementSize = sizeof(value_type);
+                header()->size = 0;
+                return;
+            }
+            if (bytes < HeaderBytes)
+                throw std::runtime_error(path + " is not a MappedVector file!");
+            mapping = map(bytes);
+            mappedBytes = bytes;
+            capacity = (bytes - HeaderBytes) / sizeof(value_type);
+            if (std::memcmp(header()->magic, magic(), sizeof(header()->magic)) != 0
+                    || header()->elementSize != sizeof(value_type) || header()->size > capacity)
+                throw std::runtime_error(path + " is not a MappedVector file of this element type!");
+            current_size = static_cast<size_type>(header()->size);
+        }
+
+        void checkWritable() const
+        {
+            if (readOnly)
+                throw std::logic_error("You are trying to modify a read-only mapped vector!");
+        }
+
+        void setSize(size_type count)
+        {
+            current_size = count;
+            header()->size = count;
+        }
+
+        // Resizes the file to new_capacity elements. The new mapping is made
+        // before the old one goes, so a failure leaves the vector intact.
+        void remap(size_type new_capacity)
+        {
+            size_type bytes = fileBytes(new_capacity);
+            if (::ftruncate(file, static_cast<off_t>(bytes)) != 0)
+                fail("Cannot resize the vector's file");
+            unsigned char* new_mapping;
+            try
+            {
+                new_mapping = map(bytes);
+            }
+            catch (...)
+            {
+                // Best effort; a longer file only holds unused capacity.
+                if (::ftruncate(file, static_cast<off_t>(mappedBytes)) != 0)
+                {}
+                throw;
+            }
+            ::munmap(mapping, mappedBytes);
+            mapping = new_mapping;
+            mappedBytes = bytes;
+            capacity = new_capacity;
+        }
+
+        void reserveMore(size_type count)
+        {
+            checkWritable();
+            if (count > capacity - current_size)
+                remap(GrowthPolicy::grow(capacity, current_size + count));
+        }
+
+        // Whether it names one of the elements, which a remap would unmap.
+        // Iterators that do not yield references cannot.
+        template <typename ForwardIt>
+        bool isElement(const ForwardIt& it, std::true_type) const
+        {
+            const_pointer address = std::addressof(*it);
+            std::less<const_pointer> before;
+            return !before(address, elements()) && before(address, elements() + current_size);
+        }
+
+        template <typename ForwardIt>
+        bool isElement(const ForwardIt&, std::false_type) const
+        {
+            return false;
+        }
+
+        template <typename InputIt>
+        using RequireInputIterator = typename std::enable_if<std::is_convertible<
+                typename std::iterator_traits<InputIt>::iterator_category, std::input_iterator_tag>::value>::type;
+
+        // A single-pass range is read into memory first, as its length is
+        // only known at the end.
+        template <typename InputIt>
+        void appendRange(InputIt first, InputIt last, std::input_iterator_tag)
+        {
+            Vector<value_type> items(first, last);
+            appendRange(items.begin(), items.end(), std::forward_iterator_tag());
+        }
+
+        template <typename ForwardIt>
+        void appendRange(ForwardIt first, ForwardIt last, std::forward_iterator_tag)
+        {
+            size_type count = std::distance(first, last);
+            using YieldsElements = std::is_same<typename std::decay<typename std::iterator_traits<ForwardIt>::reference>::type, value_type>;
+            using YieldsReferences = std::integral_constant<bool, YieldsElements::value
+                    && std::is_lvalue_reference<typename std::iterator_traits<ForwardIt>::reference>::value>;
+            if (count > capacity - current_size && isElement(first, YieldsReferences()))
+            {
+                Vector<value_type> copy(first, last);
+                appendRange(copy.begin(), copy.end(), std::forward_iterator_tag());
+                return;
+            }
+            reserveMore(count);
+            std::copy(first, last, elements() + current_size);
+            setSize(current_size + count);
+        }
+
+        size_type positionOf(const const_iterator& it) const
+        {
+            return static_cast<size_type>(it.element - elements());
+        }
+
+        // Opens count slots at index, shifting the elements behind it.
+        pointer openGap(size_type index, size_type count)
+        {
+            reserveMore(count);
+            pointer position = elements() + index;
+            std::memmove(static_cast<void*>(position + count), static_cast<const void*>(position),
+                         (current_size - index) * sizeof(value_type));
+            setSize(current_size + count);
+            return position;
+        }
+
+    public:
+        // Opens path, creating an empty vector there if it does not exist.
+        // ReadOnly never creates a file.
+        explicit MappedVector(const std::string& path, MapMode mode = MapMode::ReadWrite)
+            : readOnly(mode == MapMode::ReadOnly)
+        {
+            file = ::open(path.c_str(), readOnly ? O_RDONLY | O_CLOEXEC : O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+            if (file < 0)
+                fail("Cannot open " + path);
+            try
+            {
+                openMapping(path);
+            }
+            catch (...)
+            {
+                release();
+                throw;
+            }
+        }
+
+        // Two vectors writing one mapping would disagree on its size.
+        MappedVector(const MappedVector&) = delete;
+        MappedVector& operator=(const MappedVector&) = delete;
+
+        MappedVector(MappedVector&& other) noexcept
+            : file(other.file), readOnly(other.readOnly), mapping(other.mapping), mappedBytes(other.mappedBytes),
+              current_size(other.current_size), capacity(other.capacity)
+        {
+            other.file = -1;
+            other.mapping = nullptr;
+            other.current_size = 0;
+            other.capacity = 0;
+        }
+
+        MappedVector& operator=(MappedVector&& other) noexcept
+        {
+            if (this == &other)
+                return *this;
+            release();
+            file = other.file;
+            readOnly = other.readOnly;
+            mapping = other.mapping;
+            mappedBytes = other.mappedBytes;
+            current_size = other.current_size;
+            capacity = other.capacity;
+            other.file = -1;
+            other.mapping = nullptr;
+            other.current_size = 0;
+            other.capacity = 0;
+            return *this;
+        }
+
+        // Unmaps without waiting for the disk; the page cache still writes
+        // everything back. Call flush() first for durability.
+        ~MappedVector()
+        {
+            release();
+        }
+
+        // Writes the header and elements back to the file. With wait false
+        // the write-back is only started.
+        void flush(bool wait = true)
+        {
+            if (readOnly || mapping == nullptr)
+                return;
+            if (::msync(mapping, fileBytes(current_size), wait ? MS_SYNC : MS_ASYNC) != 0)
+                fail("Cannot flush the vector's file");
+        }
+
+        bool isReadOnly() const
+        {
+            return readOnly;
+        }
+
+        bool isEmpty() const
+        {
+            return current_size == 0;
+        }
+
+        size_type getSize() const
+        {
+            return current_size;
+        }
+
+        size_type getCapacity() const
+        {
+            return capacity;
+        }
+
+        pointer data()
+        {
+            return elements();
+        }
+
+        const_pointer data() const
+        {
+            return elements();
+        }
+
+        void reserve(size_type count)
+        {
+            checkWritable();
+            if (count > capacity)
+                remap(count);
+        }
+
+        // Truncates the file to the elements in use.
+        void shrinkToFit()
+        {
+            checkWritable();
+            if (capacity > current_size)
+                remap(current_size);
+        }
+
+        void append(const Type& item)
+        {
+            emplaceBack(item);
+        }
+
+        // One remap at most, however long the range. A range of this
+        // vector's own elements is copied out first when the remap would
+        // unmap it.
+        template <typename InputIt, typename = RequireInputIterator<InputIt>>
+        void append(InputIt first, InputIt last)
+        {
+            appendRange(first, last, typename std::iterator_traits<InputIt>::iterator_category());
+        }
+
+        void prepend(const Type& item)
+        {
+            value_type copy(item);
+            *openGap(0, 1) = copy;
+        }
+
+        void insert(const const_iterator& insertPosition, const Type& item)
+        {
+            value_type copy(item);
+            *openGap(positionOf(insertPosition), 1) = copy;
+        }
+
+        // The element is built before growing, in case args refer to one
+        // that growing moves.
+        template <typename... Args>
+        reference emplaceBack(Args&&... args)
+        {
+            value_type item(std::forward<Args>(args)...);
+            reserveMore(1);
+            pointer slot = elements() + current_size;
+            *slot = item;
+            setSize(current_size + 1);
+            return *slot;
+        }
+
+        Type popFirst()
+        {
+            checkWritable();
+            if (current_size == 0)
+                throw std::logic_error("You are trying to pop an empty vector!");
+            value_type first = elements()[0];
+            erase(cbegin());
+            return first;
+        }
+
+        Type popLast()
+        {
+            checkWritable();
+            if (current_size == 0)
+                throw std::logic_error("You are trying to pop an empty vector!");
+            setSize(current_size - 1);
+            return elements()[current_size];
+        }
+
+        void erase(const const_iterator& possition)
+        {
+            if (possition == end())
+                throw std::out_of_range("Erasing vector end!");
+            erase(possition, possition + 1);
+        }
+
+        void erase(const const_iterator& firstIncluded, const const_iterator& lastExcluded)
+        {
+            checkWritable();
+            if (firstIncluded == end())
+                throw std::out_of_range("Erasing vector end!");
+            size_type first = positionOf(firstIncluded);
+            size_type last = positionOf(lastExcluded);
+            std::memmove(static_cast<void*>(elements() + first), static_cast<const void*>(elements() + last),
+                         (current_size - last) * sizeof(value_type));
+            setSize(current_size - (last - first));
+        }
+
+        iterator begin()
+        {
+            return iterator(cbegin());
+        }
+
+        iterator end()
+        {
+            return iterator(cend());
+        }
+
+        const_iterator cbegin() const
+        {
+            return ConstIterator(elements(), this);
+        }
+
+        const_iterator cend() const
+        {
+            return ConstIterator(elements() + current_size, this);
+        }
+
+        const_iterator begin() const
+        {
+            return cbegin();
+        }
+
+        const_iterator end() const
+        {
+            return cend();
+        }
+    };
+
+    template <typename Type, typename GrowthPolicy>
+    class MappedVector<Type, GrowthPolicy>::ConstIterator
+    {
+    public:
+        friend class MappedVector;
+        using iterator_category = std::random_access_iterator_tag;
+#if __cplusplus >= 202002L
+        using iterator_concept = std::contiguous_iterator_tag;
+#endif
+        using value_type = typename MappedVector::value_type;
+        using difference_type = typename MappedVector::difference_type;
+        using pointer = typename MappedVector::const_pointer;
+        using reference = typename MappedVector::const_reference;
+
+    private:
+        pointer element;
+#if AISDI_CHECKED_ITERATORS
+        MappedVector const * vector_pointer;
+
+        difference_type position() const
+        {
+            return element - vector_pointer->elements();
+        }
+
+        void checkRange(difference_type d) const
+        {
+            if (position() + d < 0 || position() + d > static_cast<difference_type>(vector_pointer->current_size))
+                throw std::out_of_range("Moving iterator outside of vector!");
+        }
+#endif
+
+    public:
+        explicit ConstIterator(pointer element_ = nullptr, MappedVector const * vector_pointer_ = nullptr)
+        {
+            element = element_;
+#if AISDI_CHECKED_ITERATORS
+            vector_pointer = vector_pointer_;
+#else
+            (void)vector_pointer_;
+#endif
+        }
+
+        reference operator*() const
+        {
+#if AISDI_CHECKED_ITERATORS
+            if (position() == static_cast<difference_type>(vector_pointer->current_size))
+                throw std::out_of_range("Dereferencing vector end!");
+#endif
+            return *element;
+        }
+
+        pointer operator->() const
+        {
+            return &operator*();
+        }
+
+        reference operator[](difference_type d) const
+        {
+            return *(*this + d);
+        }
+
+        ConstIterator& operator++()
+        {
+            return operator+=(1);
+        }
+
+        ConstIterator operator++(int)
+        {
+            auto Ret = *this;
+            operator++();
+            return Ret;
+        }
+
+        ConstIterator& operator--()
+        {
+            return operator+=(-1);
+        }
+
+        ConstIterator operator--(int)
+        {
+            auto Ret = *this;
+            operator--();
+            return Ret;
+        }
+
+        ConstIterator& operator+=(difference_type d)
+        {
+#if AISDI_CHECKED_ITERATORS
+            checkRange(d);
+#endif
+            element += d;
+            return *this;
+        }
+
+        ConstIterator& operator-=(difference_type d)
+        {
+            return operator+=(-d);
+        }
+
+        ConstIterator operator+(difference_type d) const
+        {
+            auto Ret = *this;
+            Ret += d;
+            return Ret;
+        }
+
+        ConstIterator operator-(difference_type d) const
+        {
+            auto Ret = *this;
+            Ret -= d;
+            return Ret;
+        }
+
+        friend ConstIterator operator+(difference_type d, const ConstIterator& it)
+        {
+            return it + d;
+        }
+
+        difference_type operator-(const ConstIterator& other) const
+        {
+            return element - other.element;
+        }
+
+        bool operator==(const ConstIterator& other) const
+        {
+            return element == other.element;
+        }
+
+        bool operator!=(const ConstIterator& other) const
+        {
+            return element != other.element;
+        }
+
+        bool operator<(const ConstIterator& other) const
+        {
+            return element < other.element;
+        }
+
+        bool operator>(const ConstIterator& other) const
+        {
+            return element > other.element;
+        }
+
+        bool operator<=(const ConstIterator& other) const
+        {
+            return element <= other.element;
+        }
+
+        bool operator>=(const ConstIterator& other) const
+        {
+            return element >= other.element;
+        }
+    };
+
+    template <typename Type, typename GrowthPolicy>
+    class MappedVector<Type, GrowthPolicy>::Iterator : public MappedVector<Type, GrowthPolicy>::ConstIterator
+    {
+    public:
+        using pointer = typename MappedVector::pointer;
+        using reference = typename MappedVector::reference;
+
+        explicit Iterator()
+        {}
+
+        Iterator(const ConstIterator& other)
+                : ConstIterator(other)
+        {}
+
+        Iterator& operator++()
+        {
+            ConstIterator::operator++();
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            auto result = *this;
+            ConstIterator::operator++();
+            return result;
+        }
+
+        Iterator& operator--()
+        {
+            ConstIterator::operator--();
+            return *this;
+        }
+
+        Iterator operator--(int)
+        {
+            auto result = *this;
+            ConstIterator::operator--();
+            return result;
+        }
+
+        Iterator& operator+=(difference_type d)
+        {
+            ConstIterator::operator+=(d);
+            return *this;
+        }
+
+        Iterator& operator-=(difference_type d)
+        {
+            ConstIterator::operator-=(d);
+            return *this;
+        }
+
+        Iterator operator+(difference_type d) const
+        {
+            return ConstIterator::operator+(d);
+        }
+
+        friend Iterator operator+(difference_type d, const Iterator& it)
+        {
+            return it + d;
+        }
+
+        using ConstIterator::operator-;
+
+        Iterator operator-(difference_type d) const
+        {
+            return ConstIterator::operator-(d);
+        }
+
+        reference operator*() const
+        {
+            return const_cast<reference>(ConstIterator::operator*());
+        }
+
+        pointer operator->() const
+        {
+            return &operator*();
+        }
+
+        reference operator[](difference_type d) const
+        {
+            return *(*this + d);
+        }
+    };
+
+}
+
+#endif // AISDI_LINEAR_MAPPEDVECTOR_H
@@ -0,0 +1,341 @@
+#ifndef AISDI_LINEAR_NODEPOOL_H
+#define AISDI_LINEAR_NODEPOOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "Allocator.h"
+
+namespace aisdi
+{
+
+    // Caller-supplied block of memory. Pools carve whole chunks out of it
+    // with a bump pointer before falling back to the heap; the memory is
+    // never freed by the pool, so the arena has to outlive every list using it.
+    class NodeArena
+    {
+    private:
+        char* memory;
+        std::size_t bytes;
+        std::size_t used;
+
+    public:
+        NodeArena(void* memory_, std::size_t bytes_)
+        {
+            memory = static_cast<char*>(memory_);
+            bytes = bytes_;
+            used = 0;
+        }
+
+        NodeArena(const NodeArena&) = delete;
+        NodeArena& operator=(const NodeArena&) = delete;
+
+        void* allocate(std::size_t size, std::size_t alignment)
+        {
+            std::uintptr_t address = reinterpret_cast<std::uintptr_t>(memory + used);
+            std::size_t padding = (alignment - address % alignment) % alignment;
+            if (padding + size > bytes - used)
+                return nullptr;
+            used += padding + size;
+            return memory + used - size;
+        }
+
+        std::size_t remaining() const
+        {
+            return bytes - used;
+        }
+    };
+
+    // Hands out Node-sized slots from contiguous chunks. Released slots go
+    // on an intrusive free list and are reused before any new chunk is taken.
+    // Chunks not carved from an arena come from Allocator (rebound to the
+    // slot type). Every slot names the chunk list it was carved from, at the
+    // cost of a pointer per node: a node spliced into another list goes
+    // back to its own chunk list when released there, and a chunk list
+    // outlives its pool only until the last of its nodes is released, so
+    // splicing needs no bookkeeping and holds no memory past its nodes.
+    // Each chunk list keeps the allocator that frees its chunks.
+    template <typename Node, typename Allocator = std::allocator<Node>>
+    class NodePool : private AllocatorHolder<Allocator>
+    {
+    private:
+        struct ChunkList;
+        struct Slot;
+
+        union Body
+        {
+            Slot* next;
+            alignas(Node) unsigned char storage[sizeof(Node)];
+        };
+
+        struct Slot
+        {
+            ChunkList* owner;
+            Body body;
+        };
+
+        using SlotAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Slot>;
+        using SlotTraits = std::allocator_traits<SlotAllocator>;
+        using Chunk = std::pair<Slot*, std::size_t>;
+        using ChunkAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Chunk>;
+        using ListAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<ChunkList>;
+        using ListTraits = std::allocator_traits<ListAllocator>;
+
+        struct ChunkList
+        {
+            SlotAllocator allocator;
+            std::vector<Chunk, ChunkAllocator> chunks;
+            // Slots released through other pools, possibly on other
+            // threads. They are pushed with a CAS and taken back all at once
+            // with an exchange, so the stack has no ABA problem.
+            std::atomic<Slot*> returned;
+            // Minus the slots released through other pools. The owning pool
+            // adds the slots it handed out and did not get back when it goes
+            // away; whoever brings the balance to zero frees the list.
+            std::atomic<std::size_t> balance;
+
+            explicit ChunkList(const SlotAllocator& allocator_)
+                : allocator(allocator_), chunks(ChunkAllocator(allocator_)), returned(nullptr), balance(0)
+            {}
+
+            ~ChunkList()
+            {
+                for (const auto& chunk : chunks)
+                    SlotTraits::deallocate(allocator, chunk.first, chunk.second);
+            }
+        };
+
+        static const std::size_t InitialChunkNodes = 16;
+        static const std::size_t MaxChunkNodes = 4096;
+
+        Slot* freeList = nullptr;
+        Slot* cursor = nullptr;
+        Slot* chunkEnd = nullptr;
+        std::size_t nextChunkNodes = InitialChunkNodes;
+        // Slots of chunks handed out and not released through this pool.
+        std::size_t handedOut = 0;
+        ChunkList* chunks = nullptr;
+        NodeArena* arena;
+
+        static Slot* slotOf(void* node)
+        {
+            return reinterpret_cast<Slot*>(static_cast<unsigned char*>(node) - offsetof(Slot, body));
+        }
+
+        static void destroyList(ChunkList* chunkList)
+        {
+            ListAllocator listAllocator(chunkList->allocator);
+            ListTraits::destroy(listAllocator, chunkList);
+            ListTraits::deallocate(listAllocator, chunkList, 1);
+        }
+
+        // Sends a slot of another pool back to its chunk list.
+        static void giveBack(Slot* slot)
+        {
+            ChunkList* owner = slot->owner;
+            Slot* first = owner->returned.load(std::memory_order_relaxed);
+            do
+                slot->body.next = first;
+            while (!owner->returned.compare_exchange_weak(first, slot, std::memory_order_release, std::memory_order_relaxed));
+            if (owner->balance.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                destroyList(owner);
+        }
+
+        void addChunk(std::size_t count)
+        {
+            if (chunks == nullptr)
+            {
+                ListAllocator listAllocator(this->allocator());
+                ChunkList* created = ListTraits::allocate(listAllocator, 1);
+                try
+                {
+                    ListTraits::construct(listAllocator, created, SlotAllocator(this->allocator()));
+                }
+                catch (...)
+                {
+                    ListTraits::deallocate(listAllocator, created, 1);
+                    throw;
+                }
+                chunks = created;
+            }
+            Slot* chunk = nullptr;
+            if (arena != nullptr && arena->remaining() >= sizeof(Slot))
+            {
+                std::size_t fitting = arena->remaining() / sizeof(Slot);
+                std::size_t taken = count < fitting ? count : fitting;
+                chunk = static_cast<Slot*>(arena->allocate(taken * sizeof(Slot), alignof(Slot)));
+                if (chunk != nullptr)
+                    count = taken;
+            }
+            if (chunk == nullptr)
+            {
+                chunks->chunks.reserve(chunks->chunks.size() + 1);
+                chunk = SlotTraits::allocate(chunks->allocator, count);
+                chunks->chunks.push_back(Chunk(chunk, count));
+            }
+            cursor = chunk;
+            chunkEnd = chunk + count;
+        }
+
+        void release()
+        {
+            if (chunks != nullptr && chunks->balance.fetch_add(handedOut, std::memory_order_acq_rel) + handedOut == 0)
+                destroyList(chunks);
+            chunks = nullptr;
+            freeList = cursor = chunkEnd = nullptr;
+            nextChunkNodes = InitialChunkNodes;
+            handedOut = 0;
+        }
+
+    public:
+        explicit NodePool(NodeArena* arena_ = nullptr, const Allocator& allocator_ = Allocator())
+            : AllocatorHolder<Allocator>(allocator_)
+        {
+            arena = arena_;
+        }
+
+        using AllocatorHolder<Allocator>::allocator;
+
+        NodeArena* getArena() const
+        {
+            return arena;
+        }
+
+        // Chunks taken from now on come from arena_ while it lasts.
+        void setArena(NodeArena* arena_)
+        {
+            arena = arena_;
+        }
+
+        NodePool(const NodePool&) = delete;
+        NodePool& operator=(const NodePool&) = delete;
+
+        ~NodePool()
+        {
+            release();
+        }
+
+        void* allocate()
+        {
+            // Slots other pools sent back are only looked at once the
+            // current chunk is used up, to keep atomics off the common path.
+            if (freeList == nullptr && cursor == chunkEnd && chunks != nullptr)
+                freeList = chunks->returned.exchange(nullptr, std::memory_order_acquire);
+            handedOut++;
+            if (freeList != nullptr)
+            {
+                Slot* slot = freeList;
+                freeList = slot->body.next;
+                return slot->body.storage;
+            }
+            if (cursor == chunkEnd)
+            {
+                try
+                {
+                    addChunk(nextChunkNodes);
+                }
+                catch (...)
+                {
+                    handedOut--;
+                    throw;
+                }
+                if (nextChunkNodes < MaxChunkNodes)
+                    nextChunkNodes *= 2;
+            }
+            cursor->owner = chunks;
+            return (cursor++)->body.storage;
+        }
+
+        void deallocate(void* node)
+        {
+            Slot* slot = slotOf(node);
+            if (slot->owner != chunks)
+            {
+                giveBack(slot);
+                return;
+            }
+            slot->body.next = freeList;
+            freeList = slot;
+            handedOut--;
+        }
+
+        // Makes the next count allocations come from one chunk, after any
+        // free slots. What is left of the current chunk goes on the free list.
+        void reserve(std::size_t count)
+        {
+            if (static_cast<std::size_t>(chunkEnd - cursor) >= count)
+                return;
+            while (cursor != chunkEnd)
+            {
+                cursor->owner = chunks;
+                cursor->body.next = freeList;
+                freeList = cursor++;
+            }
+            addChunk(count);
+        }
+
+        // Exchanges the slots but not the allocators: callers swap pools
+        // whose allocators compare equal, or exchange those themselves.
+        void swap(NodePool& other)
+        {
+            std::swap(freeList, other.freeList);
+            std::swap(cursor, other.cursor);
+            std::swap(chunkEnd, other.chunkEnd);
+            std::swap(nextChunkNodes, other.nextChunkNodes);
+            std::swap(handedOut, other.handedOut);
+            std::swap(chunks, other.chunks);
+            std::swap(arena, other.arena);
+        }
+    };
+
+    // One allocation per node, as LinkedList did before pooling. Kept as a
+    // baseline and for types that must not share chunk lifetimes.
+    template <typename Node, typename Allocator = std::allocator<Node>>
+    class NodeHeap : private AllocatorHolder<Allocator>
+    {
+    private:
+        using NodeAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+        using NodeTraits = std::allocator_traits<NodeAllocator>;
+
+    public:
+        explicit NodeHeap(NodeArena* = nullptr, const Allocator& allocator_ = Allocator())
+            : AllocatorHolder<Allocator>(allocator_)
+        {}
+
+        using AllocatorHolder<Allocator>::allocator;
+
+        NodeArena* getArena() const
+        {
+            return nullptr;
+        }
+
+        void setArena(NodeArena*)
+        {}
+
+        void* allocate()
+        {
+            NodeAllocator nodeAllocator(allocator());
+            return NodeTraits::allocate(nodeAllocator, 1);
+        }
+
+        void deallocate(void* node)
+        {
+            NodeAllocator nodeAllocator(allocator());
+            NodeTraits::deallocate(nodeAllocator, static_cast<Node*>(node), 1);
+        }
+
+        void reserve(std::size_t)
+        {}
+
+        void swap(NodeHeap&)
+        {}
+    };
+
+}
+
+#endif // AISDI_LINEAR_NODEPOOL_H
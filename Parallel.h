@@ -0,0 +1,269 @@
+#ifndef AISDI_LINEAR_PARALLEL_H
+#define AISDI_LINEAR_PARALLEL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ThreadPool.h"
+
+namespace aisdi
+{
+
+    // Splits a contiguous range (a Vector's, typically) into chunks whose
+    // inner boundaries fall on cache-line boundaries, so no two workers ever
+    // write to the same line. Chunks hold at least MinChunkBytes and there
+    // are about ChunksPerThread of them per worker, which leaves enough
+    // slack for stealing to even out the load.
+    class ParallelChunks
+    {
+    private:
+        static const std::size_t CacheLine = 64;
+        static const std::size_t MinChunkBytes = 64 * 1024;
+        static const std::size_t ChunksPerThread = 8;
+
+        std::size_t size;
+        std::size_t chunk;
+        // Index of the first element that starts a cache line.
+        std::size_t skew;
+
+        // State shared by the tasks of one parallel call. The caller waits
+        // on pending and rethrows the first exception a chunk threw.
+        struct Join
+        {
+            std::atomic<std::size_t> pending;
+            std::mutex mutex;
+            std::exception_ptr error;
+
+            Join()
+                : pending(0)
+            {}
+
+            void fail()
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error)
+                    error = std::current_exception();
+            }
+        };
+
+        // Hands the upper half of [first, last) to the pool until one chunk
+        // is left, then runs it. Thieves take the oldest, largest halves.
+        template <typename Body>
+        static void split(ThreadPool& pool, std::size_t first, std::size_t last, Body& body, Join& join)
+        {
+            while (last - first > 1)
+            {
+                std::size_t middle = first + (last - first) / 2;
+                join.pending.fetch_add(1);
+                try
+                {
+                    pool.submit([&pool, middle, last, &body, &join] {
+                        split(pool, middle, last, body, join);
+                        join.pending.fetch_sub(1, std::memory_order_release);
+                    });
+                }
+                catch (...)
+                {
+                    // Could not queue it; run the rest here instead.
+                    join.pending.fetch_sub(1);
+                    break;
+                }
+                last = middle;
+            }
+            try
+            {
+                for (std::size_t index = first; index < last; ++index)
+                    body(index);
+            }
+            catch (...)
+            {
+                join.fail();
+            }
+        }
+
+    public:
+        template <typename Type>
+        ParallelChunks(const Type* data, std::size_t size_, std::size_t threads)
+        {
+            size = size_;
+            std::size_t lineElements = sizeof(Type) < CacheLine && CacheLine % sizeof(Type) == 0 ? CacheLine / sizeof(Type) : 1;
+            std::size_t misalignment = reinterpret_cast<std::uintptr_t>(data) % CacheLine;
+            skew = lineElements > 1 && misalignment % sizeof(Type) == 0
+                   ? (CacheLine - misalignment) % CacheLine / sizeof(Type) : 0;
+            chunk = size / ((threads == 0 ? 1 : threads) * ChunksPerThread);
+            if (chunk < MinChunkBytes / sizeof(Type))
+                chunk = MinChunkBytes / sizeof(Type);
+            chunk = (chunk + lineElements - 1) / lineElements * lineElements;
+            if (chunk == 0)
+                chunk = 1;
+        }
+
+        std::size_t count() const
+        {
+            return size <= skew + chunk ? 1 : 1 + (size - skew - 1) / chunk;
+        }
+
+        std::size_t begin(std::size_t index) const
+        {
+            return index == 0 ? 0 : skew + index * chunk;
+        }
+
+        std::size_t end(std::size_t index) const
+        {
+            std::size_t last = skew + (index + 1) * chunk;
+            return last < size ? last : size;
+        }
+
+        // Calls body(index) for every chunk index, on the pool and on the
+        // calling thread, and returns once all have finished.
+        template <typename Body>
+        void run(ThreadPool& pool, Body body) const
+        {
+            std::size_t chunks = count();
+            if (chunks == 1 || pool.getThreadCount() == 0)
+            {
+                for (std::size_t index = 0; index < chunks; ++index)
+                    body(index);
+                return;
+            }
+            Join join;
+            split(pool, 0, chunks, body, join);
+            while (join.pending.load(std::memory_order_acquire) != 0)
+                if (!pool.runPendingTask())
+                    std::this_thread::yield();
+            if (join.error)
+                std::rethrow_exception(join.error);
+        }
+    };
+
+    // The algorithms below take random-access iterators over contiguous
+    // storage, such as Vector's. Elements are visited in unspecified order
+    // and concurrently, so the functions must be safe to call that way.
+
+    template <typename Iterator, typename Function>
+    void parallelForEach(ThreadPool& pool, Iterator first, Iterator last, Function function)
+    {
+        if (first == last)
+            return;
+        ParallelChunks chunks(std::addressof(*first), last - first, pool.getThreadCount());
+        chunks.run(pool, [&](std::size_t index) {
+            for (Iterator it = first + chunks.begin(index), stop = first + chunks.end(index); it != stop; ++it)
+                function(*it);
+        });
+    }
+
+    // Writes function(first[i]) to destination[i]. Chunks follow the
+    // destination's cache lines, as that is where the writes go.
+    template <typename InputIterator, typename OutputIterator, typename Function>
+    OutputIterator parallelTransform(ThreadPool& pool, InputIterator first, InputIterator last,
+                                     OutputIterator destination, Function function)
+    {
+        if (first == last)
+            return destination;
+        ParallelChunks chunks(std::addressof(*destination), last - first, pool.getThreadCount());
+        chunks.run(pool, [&](std::size_t index) {
+            OutputIterator out = destination + chunks.begin(index);
+            for (InputIterator it = first + chunks.begin(index), stop = first + chunks.end(index); it != stop; ++it, ++out)
+                *out = function(*it);
+        });
+        return destination + (last - first);
+    }
+
+    // Folds every chunk on its own and then the partial results in order,
+    // so operation has to be associative but need not be commutative.
+    template <typename Iterator, typename Type, typename Operation>
+    Type parallelReduce(ThreadPool& pool, Iterator first, Iterator last, Type init, Operation operation)
+    {
+        if (first == last)
+            return init;
+        ParallelChunks chunks(std::addressof(*first), last - first, pool.getThreadCount());
+        std::vector<std::unique_ptr<Type>> partials(chunks.count());
+        chunks.run(pool, [&](std::size_t index) {
+            Iterator it = first + chunks.begin(index);
+            Iterator stop = first + chunks.end(index);
+            Type partial = *it;
+            for (++it; it != stop; ++it)
+                partial = operation(partial, *it);
+            partials[index].reset(new Type(std::move(partial)));
+        });
+        for (const auto& partial : partials)
+            init = operation(init, *partial);
+        return init;
+    }
+
+    // Returns the first element matching predicate, or last. Chunks past
+    // a match already found are skipped.
+    template <typename Iterator, typename Predicate>
+    Iterator parallelFindIf(ThreadPool& pool, Iterator first, Iterator last, Predicate predicate)
+    {
+        if (first == last)
+            return last;
+        std::size_t size = last - first;
+        ParallelChunks chunks(std::addressof(*first), size, pool.getThreadCount());
+        std::atomic<std::size_t> found(size);
+        chunks.run(pool, [&](std::size_t index) {
+            std::size_t position = chunks.begin(index);
+            if (position >= found.load(std::memory_order_relaxed))
+                return;
+            for (Iterator it = first + position, stop = first + chunks.end(index); it != stop; ++it, ++position)
+                if (predicate(*it))
+                {
+                    std::size_t best = found.load(std::memory_order_relaxed);
+                    while (position < best && !found.compare_exchange_weak(best, position, std::memory_order_relaxed))
+                    {}
+                    return;
+                }
+        });
+        return first + found.load();
+    }
+
+    template <typename Iterator, typename Type>
+    Iterator parallelFind(ThreadPool& pool, Iterator first, Iterator last, const Type& value)
+    {
+        return parallelFindIf(pool, first, last, [&value](const typename std::iterator_traits<Iterator>::value_type& item) {
+            return item == value;
+        });
+    }
+
+    // Overloads running on ThreadPool::defaultPool().
+
+    template <typename Iterator, typename Function>
+    void parallelForEach(Iterator first, Iterator last, Function function)
+    {
+        parallelForEach(ThreadPool::defaultPool(), first, last, function);
+    }
+
+    template <typename InputIterator, typename OutputIterator, typename Function>
+    OutputIterator parallelTransform(InputIterator first, InputIterator last, OutputIterator destination, Function function)
+    {
+        return parallelTransform(ThreadPool::defaultPool(), first, last, destination, function);
+    }
+
+    template <typename Iterator, typename Type, typename Operation>
+    Type parallelReduce(Iterator first, Iterator last, Type init, Operation operation)
+    {
+        return parallelReduce(ThreadPool::defaultPool(), first, last, init, operation);
+    }
+
+    template <typename Iterator, typename Predicate>
+    Iterator parallelFindIf(Iterator first, Iterator last, Predicate predicate)
+    {
+        return parallelFindIf(ThreadPool::defaultPool(), first, last, predicate);
+    }
+
+    template <typename Iterator, typename Type>
+    Iterator parallelFind(Iterator first, Iterator last, const Type& value)
+    {
+        return parallelFind(ThreadPool::defaultPool(), first, last, value);
+    }
+
+}
+
+#endif // AISDI_LINEAR_PARALLEL_H
@@ -0,0 +1,635 @@
+#ifndef AISDI_LINEAR_SEGMENTEDVECTOR_H
+#define AISDI_LINEAR_SEGMENTEDVECTOR_H
+
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "Allocator.h"
+#include "Config.h"
+
+namespace aisdi
+{
+
+    // A vector that grows by adding blocks instead of reallocating: block k
+    // holds FirstBlock << k elements, so n elements take O(log n) blocks and
+    // at most twice their room. Elements never move, so appending costs the
+    // same at any size, with no copy of everything when the capacity runs
+    // out, and pointers, references and iterators to an element stay valid
+    // until it is popped. Indexing finds the block from the bit length of
+    // the index in O(1); the block table lives in the object itself.
+    template <typename Type, std::size_t FirstBlock = 16, typename Allocator = std::allocator<Type>>
+    class SegmentedVector : private AllocatorHolder<Allocator>
+    {
+        static_assert(FirstBlock > 0 && (FirstBlock & (FirstBlock - 1)) == 0, "FirstBlock has to be a power of two!");
+        static_assert(std::is_same<typename Allocator::value_type, Type>::value, "The allocator has to allocate the element type!");
+
+    public:
+        using difference_type = std::ptrdiff_t;
+        using size_type = std::size_t;
+        using value_type = Type;
+        using pointer = Type*;
+        using reference = Type&;
+        using const_pointer = const Type*;
+        using const_reference = const Type&;
+        using allocator_type = Allocator;
+
+        class ConstIterator;
+        class Iterator;
+        using iterator = Iterator;
+        using const_iterator = ConstIterator;
+
+    private:
+        using Holder = AllocatorHolder<Allocator>;
+        using Holder::allocator;
+        using Traits = std::allocator_traits<Allocator>;
+        using Propagation = AllocatorPropagation<Allocator>;
+
+        static size_type bitLength(size_type value)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return sizeof(unsigned long long) * CHAR_BIT - __builtin_clzll(value);
+#else
+            size_type length = 0;
+            for (; value != 0; value >>= 1)
+                length++;
+            return length;
+#endif
+        }
+
+        static size_type shift()
+        {
+            return bitLength(FirstBlock) - 1;
+        }
+
+        // Enough blocks for every index a size_type can hold.
+        static const size_type MaxBlocks = sizeof(size_type) * CHAR_BIT;
+
+        pointer blocks[MaxBlocks] = {};
+        size_type blockCount = 0;
+        size_type current_size = 0;
+
+        static size_type blockSize(size_type block)
+        {
+            return FirstBlock << block;
+        }
+
+        // Block k starts at FirstBlock * (2^k - 1), so index + FirstBlock
+        // has its top bit at k + log2(FirstBlock) and the offset below it.
+        static size_type blockOf(size_type index)
+        {
+            return bitLength(index + FirstBlock) - 1 - shift();
+        }
+
+        static size_type offsetOf(size_type index, size_type block)
+        {
+            return index + FirstBlock - blockSize(block);
+        }
+
+        pointer slotAt(size_type index) const
+        {
+            size_type block = blockOf(index);
+            return blocks[block] + offsetOf(index, block);
+        }
+
+        // The element at index and the end of its block, or null for an
+        // index past the allocated blocks.
+        std::pair<pointer, pointer> positionOf(size_type index) const
+        {
+            size_type block = blockOf(index);
+            if (block >= blockCount)
+                return std::pair<pointer, pointer>(nullptr, nullptr);
+            return std::pair<pointer, pointer>(blocks[block] + offsetOf(index, block), blocks[block] + blockSize(block));
+        }
+
+        void addBlock()
+        {
+            if (blockCount == MaxBlocks)
+                throw std::length_error("SegmentedVector has no room for another block!");
+            blocks[blockCount] = Traits::allocate(allocator(), blockSize(blockCount));
+            blockCount++;
+        }
+
+        void destroyElements()
+        {
+            while (current_size > 0)
+                Traits::destroy(allocator(), slotAt(--current_size));
+        }
+
+        // Frees the blocks from `from` on, which have to be empty.
+        void releaseBlocks(size_type from)
+        {
+            while (blockCount > from)
+            {
+                blockCount--;
+                Traits::deallocate(allocator(), blocks[blockCount], blockSize(blockCount));
+                blocks[blockCount] = nullptr;
+            }
+        }
+
+        void releaseStorage()
+        {
+            destroyElements();
+            releaseBlocks(0);
+        }
+
+        // Takes other's blocks; this vector must have none.
+        void takeStorage(SegmentedVector& other)
+        {
+            std::copy(other.blocks, other.blocks + other.blockCount, blocks);
+            std::fill(other.blocks, other.blocks + other.blockCount, nullptr);
+            blockCount = other.blockCount;
+            current_size = other.current_size;
+            other.blockCount = 0;
+            other.current_size = 0;
+        }
+
+        template <typename InputIt>
+        using RequireInputIterator = typename std::enable_if<std::is_convertible<
+                typename std::iterator_traits<InputIt>::iterator_category, std::input_iterator_tag>::value>::type;
+
+        void swapWith(SegmentedVector& other, std::true_type)
+        {
+            SegmentedVector temp(std::move(other));
+            Propagation::swapOnSwap(allocator(), other.allocator());
+            other.takeStorage(*this);
+            takeStorage(temp);
+        }
+
+        void swapWith(SegmentedVector& other, std::false_type)
+        {
+            SegmentedVector temp(std::move(other));
+            other = std::move(*this);
+            *this = std::move(temp);
+        }
+
+    public:
+        SegmentedVector() : Holder(Allocator())
+        {}
+
+        explicit SegmentedVector(const Allocator& allocator_) : Holder(allocator_)
+        {}
+
+        SegmentedVector(std::initializer_list<Type> l, const Allocator& allocator_ = Allocator()) : Holder(allocator_)
+        {
+            append(l.begin(), l.end());
+        }
+
+        template <typename InputIt, typename = RequireInputIterator<InputIt>>
+        SegmentedVector(InputIt first, InputIt last, const Allocator& allocator_ = Allocator()) : Holder(allocator_)
+        {
+            append(first, last);
+        }
+
+        SegmentedVector(const SegmentedVector& other) : Holder(Propagation::copyFor(other.allocator()))
+        {
+            append(other.begin(), other.end());
+        }
+
+        SegmentedVector(const SegmentedVector& other, const Allocator& allocator_) : Holder(allocator_)
+        {
+            append(other.begin(), other.end());
+        }
+
+        SegmentedVector(SegmentedVector&& other) noexcept : Holder(std::move(other.allocator()))
+        {
+            takeStorage(other);
+        }
+
+        ~SegmentedVector()
+        {
+            releaseStorage();
+        }
+
+        SegmentedVector& operator=(const SegmentedVector& other)
+        {
+            if (this == &other)
+                return *this;
+            if (Propagation::OnCopy::value && !(allocator() == other.allocator()))
+                releaseStorage();
+            else
+                destroyElements();
+            Propagation::assignOnCopy(allocator(), other.allocator());
+            append(other.begin(), other.end());
+            return *this;
+        }
+
+        SegmentedVector& operator=(SegmentedVector&& other)
+        {
+            if (this == &other)
+                return *this;
+            if (!Propagation::canMove(allocator(), other.allocator()))
+            {
+                destroyElements();
+                append(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+                return *this;
+            }
+            releaseStorage();
+            Propagation::assignOnMove(allocator(), other.allocator());
+            takeStorage(other);
+            return *this;
+        }
+
+        void swap(SegmentedVector& other)
+        {
+            if (this != &other)
+                swapWith(other, typename Propagation::OnSwap());
+        }
+
+        allocator_type getAllocator() const
+        {
+            return allocator();
+        }
+
+        bool isEmpty() const
+        {
+            return current_size == 0;
+        }
+
+        size_type getSize() const
+        {
+            return current_size;
+        }
+
+        size_type getCapacity() const
+        {
+            return FirstBlock * ((size_type(1) << blockCount) - 1);
+        }
+
+        // Adds blocks until count elements fit.
+        void reserve(size_type count)
+        {
+            while (getCapacity() < count)
+                addBlock();
+        }
+
+        // Frees the blocks no element is in.
+        void shrinkToFit()
+        {
+            releaseBlocks(current_size == 0 ? 0 : blockOf(current_size - 1) + 1);
+        }
+
+        reference at(size_type index)
+        {
+            if (index >= current_size)
+                throw std::out_of_range("Index out of range!");
+            return *slotAt(index);
+        }
+
+        const_reference at(size_type index) const
+        {
+            if (index >= current_size)
+                throw std::out_of_range("Index out of range!");
+            return *slotAt(index);
+        }
+
+        reference operator[](size_type index)
+        {
+            return *slotAt(index);
+        }
+
+        const_reference operator[](size_type index) const
+        {
+            return *slotAt(index);
+        }
+
+        void append(const Type& item)
+        {
+            emplaceBack(item);
+        }
+
+        void append(Type&& item)
+        {
+            emplaceBack(std::move(item));
+        }
+
+        template <typename InputIt, typename = RequireInputIterator<InputIt>>
+        void append(InputIt first, InputIt last)
+        {
+            for (; first != last; ++first)
+                emplaceBack(*first);
+        }
+
+        template <typename... Args>
+        reference emplaceBack(Args&&... args)
+        {
+            if (current_size == getCapacity())
+                addBlock();
+            pointer slot = slotAt(current_size);
+            Traits::construct(allocator(), slot, std::forward<Args>(args)...);
+            current_size++;
+            return *slot;
+        }
+
+        // Keeps the block of the popped element; shrinkToFit gives it back.
+        Type popLast()
+        {
+            if (current_size == 0)
+                throw std::logic_error("You are trying to pop an empty vector!");
+            pointer slot = slotAt(current_size - 1);
+            auto Ret = std::move(*slot);
+            Traits::destroy(allocator(), slot);
+            current_size--;
+            return Ret;
+        }
+
+        iterator begin()
+        {
+            return iterator(cbegin());
+        }
+
+        iterator end()
+        {
+            return iterator(cend());
+        }
+
+        const_iterator cbegin() const
+        {
+            return ConstIterator(this, 0);
+        }
+
+        const_iterator cend() const
+        {
+            return ConstIterator(this, current_size);
+        }
+
+        const_iterator begin() const
+        {
+            return cbegin();
+        }
+
+        const_iterator end() const
+        {
+            return cend();
+        }
+    };
+
+    // Steps through a block with a pointer and looks up the next block only
+    // when it reaches the end of one, so iterating costs little more than
+    // iterating a Vector.
+    template <typename Type, std::size_t FirstBlock, typename Allocator>
+    class SegmentedVector<Type, FirstBlock, Allocator>::ConstIterator
+    {
+    public:
+        friend class SegmentedVector;
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = typename SegmentedVector::value_type;
+        using difference_type = typename SegmentedVector::difference_type;
+        using pointer = typename SegmentedVector::const_pointer;
+        using reference = typename SegmentedVector::const_reference;
+
+    private:
+        const SegmentedVector* owner;
+        size_type index;
+        typename SegmentedVector::pointer element;
+        typename SegmentedVector::pointer blockEnd;
+
+        void seek(size_type index_)
+        {
+            index = index_;
+            std::pair<typename SegmentedVector::pointer, typename SegmentedVector::pointer> position = owner->positionOf(index);
+            element = position.first;
+            blockEnd = position.second;
+        }
+
+        void checkRange(difference_type d) const
+        {
+#if AISDI_CHECKED_ITERATORS
+            if (static_cast<difference_type>(index) + d < 0 || static_cast<difference_type>(index) + d > static_cast<difference_type>(owner->current_size))
+                throw std::out_of_range("Moving iterator outside of vector!");
+#else
+            (void)d;
+#endif
+        }
+
+    public:
+        explicit ConstIterator(const SegmentedVector* owner_ = nullptr, size_type index_ = 0)
+        {
+            owner = owner_;
+            index = 0;
+            element = blockEnd = nullptr;
+            if (owner != nullptr)
+                seek(index_);
+        }
+
+        reference operator*() const
+        {
+#if AISDI_CHECKED_ITERATORS
+            if (index >= owner->current_size)
+                throw std::out_of_range("Dereferencing end of vector!");
+#endif
+            // element is null when the iterator was made before its block
+            // existed, e.g. end() of a full vector that has grown since.
+            return element != nullptr ? *element : *owner->slotAt(index);
+        }
+
+        pointer operator->() const
+        {
+            return &**this;
+        }
+
+        reference operator[](difference_type d) const
+        {
+            return *(*this + d);
+        }
+
+        ConstIterator& operator++()
+        {
+            checkRange(1);
+            index++;
+            if (element == nullptr || ++element == blockEnd)
+                seek(index);
+            return *this;
+        }
+
+        ConstIterator operator++(int)
+        {
+            auto Ret = *this;
+            operator++();
+            return Ret;
+        }
+
+        ConstIterator& operator--()
+        {
+            checkRange(-1);
+            index--;
+            if (element == nullptr || offsetOf(index + 1, blockOf(index + 1)) == 0)
+                seek(index);
+            else
+                --element;
+            return *this;
+        }
+
+        ConstIterator operator--(int)
+        {
+            auto Ret = *this;
+            operator--();
+            return Ret;
+        }
+
+        ConstIterator& operator+=(difference_type d)
+        {
+            checkRange(d);
+            seek(index + d);
+            return *this;
+        }
+
+        ConstIterator& operator-=(difference_type d)
+        {
+            return *this += -d;
+        }
+
+        ConstIterator operator+(difference_type d) const
+        {
+            auto Ret = *this;
+            return Ret += d;
+        }
+
+        ConstIterator operator-(difference_type d) const
+        {
+            auto Ret = *this;
+            return Ret -= d;
+        }
+
+        friend ConstIterator operator+(difference_type d, const ConstIterator& it)
+        {
+            return it + d;
+        }
+
+        difference_type operator-(const ConstIterator& other) const
+        {
+            return static_cast<difference_type>(index) - static_cast<difference_type>(other.index);
+        }
+
+        bool operator==(const ConstIterator& other) const
+        {
+            return index == other.index && owner == other.owner;
+        }
+
+        bool operator!=(const ConstIterator& other) const
+        {
+            return !(*this == other);
+        }
+
+        bool operator<(const ConstIterator& other) const
+        {
+            return index < other.index;
+        }
+
+        bool operator>(const ConstIterator& other) const
+        {
+            return other < *this;
+        }
+
+        bool operator<=(const ConstIterator& other) const
+        {
+            return !(other < *this);
+        }
+
+        bool operator>=(const ConstIterator& other) const
+        {
+            return !(*this < other);
+        }
+    };
+
+    template <typename Type, std::size_t FirstBlock, typename Allocator>
+    class SegmentedVector<Type, FirstBlock, Allocator>::Iterator : public SegmentedVector<Type, FirstBlock, Allocator>::ConstIterator
+    {
+    public:
+        using pointer = typename SegmentedVector::pointer;
+        using reference = typename SegmentedVector::reference;
+
+        explicit Iterator()
+        {}
+
+        Iterator(const ConstIterator& other)
+                : ConstIterator(other)
+        {}
+
+        Iterator& operator++()
+        {
+            ConstIterator::operator++();
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            auto result = *this;
+            ConstIterator::operator++();
+            return result;
+        }
+
+        Iterator& operator--()
+        {
+            ConstIterator::operator--();
+            return *this;
+        }
+
+        Iterator operator--(int)
+        {
+            auto result = *this;
+            ConstIterator::operator--();
+            return result;
+        }
+
+        Iterator& operator+=(difference_type d)
+        {
+            ConstIterator::operator+=(d);
+            return *this;
+        }
+
+        Iterator& operator-=(difference_type d)
+        {
+            ConstIterator::operator-=(d);
+            return *this;
+        }
+
+        Iterator operator+(difference_type d) const
+        {
+            return ConstIterator::operator+(d);
+        }
+
+        Iterator operator-(difference_type d) const
+        {
+            return ConstIterator::operator-(d);
+        }
+
+        friend Iterator operator+(difference_type d, const Iterator& it)
+        {
+            return it + d;
+        }
+
+        using ConstIterator::operator-;
+
+        reference operator*() const
+        {
+            // ugly cast, yet reduces code duplication.
+            return const_cast<reference>(ConstIterator::operator*());
+        }
+
+        pointer operator->() const
+        {
+            return &**this;
+        }
+
+        reference operator[](difference_type d) const
+        {
+            return *(*this + d);
+        }
+    };
+
+    template <typename Type, std::size_t FirstBlock, typename Allocator>
+    void swap(SegmentedVector<Type, FirstBlock, Allocator>& first, SegmentedVector<Type, FirstBlock, Allocator>& second)
+    {
+        first.swap(second);
+    }
+
+}
+
+#endif // AISDI_LINEAR_SEGMENTEDVECTOR_H
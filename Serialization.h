@@ -0,0 +1,654 @@
+#ifndef AISDI_LINEAR_SERIALIZATION_H
+#define AISDI_LINEAR_SERIALIZATION_H
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <iterator>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include "Config.h"
+#include "LinkedList.h"
+#include "Vector.h"
+
+#if AISDI_POSIX
+#include <unistd.h>
+#endif
+
+namespace aisdi
+{
+
+    // Binary format of save() and saveChunked(), in the writer's byte order
+    // and type layout, so data is read back on the same kind of machine:
+    //   header    "AISDIBS1", uint32 0x01020304, uint32 element width,
+    //             uint64 element count
+    //   elements  count elements back to back, or, when count is all ones,
+    //             chunks of a uint64 n and n elements, ended by n == 0
+    // The chunked form is written before the total is known, so lists can
+    // be streamed out and read back piece by piece.
+    //
+    // BinaryCodec<Type> encodes one element. Trivially copyable types are
+    // their bytes, so a Vector of them moves as one block; strings are a
+    // uint64 length and the characters. Other types need a specialization
+    // with the same members; read() fills a default-constructed element.
+    template <typename Type, typename = void>
+    struct BinaryCodec;
+
+    namespace serialization
+    {
+        // Loads allocate at most this much ahead of the data read so far,
+        // so a corrupt count or length fails on the input running short
+        // instead of reserving whatever it claims.
+        const std::size_t ReadStepBytes = 1024 * 1024;
+
+        template <typename Type>
+        std::size_t readStep(std::size_t count)
+        {
+            const std::size_t step = ReadStepBytes / sizeof(Type) > 0 ? ReadStepBytes / sizeof(Type) : 1;
+            return count < step ? count : step;
+        }
+    }
+
+    template <typename Type>
+    struct BinaryCodec<Type, typename std::enable_if<std::is_trivially_copyable<Type>::value>::type>
+    {
+        static const bool Raw = true;
+
+        static std::uint32_t width()
+        {
+            return sizeof(Type);
+        }
+
+        template <typename Writer>
+        static void write(Writer& out, const Type& item)
+        {
+            out.write(&item, sizeof(Type));
+        }
+
+        template <typename Reader>
+        static void read(Reader& in, Type& item)
+        {
+            in.read(&item, sizeof(Type));
+        }
+    };
+
+    template <typename Char, typename Traits, typename Allocator>
+    struct BinaryCodec<std::basic_string<Char, Traits, Allocator>>
+    {
+        static const bool Raw = false;
+
+        static std::uint32_t width()
+        {
+            return sizeof(Char);
+        }
+
+        template <typename Writer>
+        static void write(Writer& out, const std::basic_string<Char, Traits, Allocator>& item)
+        {
+            std::uint64_t length = item.size();
+            out.write(&length, sizeof(length));
+            out.write(item.data(), item.size() * sizeof(Char));
+        }
+
+        template <typename Reader>
+        static void read(Reader& in, std::basic_string<Char, Traits, Allocator>& item)
+        {
+            std::uint64_t length;
+            in.read(&length, sizeof(length));
+            item.clear();
+            while (item.size() < length)
+            {
+                std::size_t offset = item.size();
+                std::size_t step = serialization::readStep<Char>(static_cast<std::size_t>(length - offset));
+                item.resize(offset + step);
+                in.read(&item[offset], step * sizeof(Char));
+            }
+        }
+    };
+
+    // Writes bytes to a stream's buffer, or to a file descriptor through a
+    // buffer of its own. Writes larger than that buffer go straight to the
+    // descriptor.
+    class BinaryWriter
+    {
+    private:
+        static const std::size_t BufferBytes = 64 * 1024;
+
+        std::ostream* stream;
+        int fd;
+        std::unique_ptr<char[]> buffer;
+        std::size_t used;
+
+        void writeThrough(const char* data, std::size_t bytes)
+        {
+            if (stream != nullptr)
+            {
+                if (static_cast<std::size_t>(stream->rdbuf()->sputn(data, static_cast<std::streamsize>(bytes))) != bytes)
+                {
+                    stream->setstate(std::ios_base::badbit);
+                    throw std::runtime_error("Cannot write the container data!");
+                }
+                return;
+            }
+#if AISDI_POSIX
+            while (bytes > 0)
+            {
+                ssize_t written = ::write(fd, data, bytes);
+                if (written < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+                    throw std::system_error(errno, std::generic_category(), "Cannot write the container data");
+                }
+                data += written;
+                bytes -= static_cast<std::size_t>(written);
+            }
+#endif
+        }
+
+        void drain()
+        {
+            if (used > 0)
+                writeThrough(buffer.get(), used);
+            used = 0;
+        }
+
+    public:
+        explicit BinaryWriter(std::ostream& stream_)
+            : stream(&stream_), fd(-1), used(0)
+        {}
+
+#if AISDI_POSIX
+        explicit BinaryWriter(int fd_)
+            : stream(nullptr), fd(fd_), buffer(new char[BufferBytes]), used(0)
+        {}
+#endif
+
+        BinaryWriter(const BinaryWriter&) = delete;
+        BinaryWriter& operator=(const BinaryWriter&) = delete;
+
+        void write(const void* data, std::size_t bytes)
+        {
+            if (stream != nullptr)
+            {
+                writeThrough(static_cast<const char*>(data), bytes);
+                return;
+            }
+            if (bytes > BufferBytes - used)
+            {
+                drain();
+                if (bytes >= BufferBytes)
+                {
+                    writeThrough(static_cast<const char*>(data), bytes);
+                    return;
+                }
+            }
+            std::memcpy(buffer.get() + used, data, bytes);
+            used += bytes;
+        }
+
+        // Hands everything written so far to the stream or descriptor.
+        void flush()
+        {
+            drain();
+            if (stream != nullptr && !stream->flush())
+                throw std::runtime_error("Cannot write the container data!");
+        }
+    };
+
+    // The reading side of BinaryWriter. Reads from a descriptor go ahead in
+    // 64 KiB blocks; finish() seeks back over what was not used, where the
+    // descriptor allows it. Large reads go straight to the destination.
+    class BinaryReader
+    {
+    private:
+        static const std::size_t BufferBytes = 64 * 1024;
+
+        std::istream* stream;
+        int fd;
+        std::unique_ptr<char[]> buffer;
+        std::size_t position;
+        std::size_t filled;
+
+        [[noreturn]] void truncated()
+        {
+            if (stream != nullptr)
+                stream->setstate(std::ios_base::eofbit | std::ios_base::failbit);
+            throw std::runtime_error("The container data ends too early!");
+        }
+
+        // Reads up to bytes; fewer only at the end of the input.
+        std::size_t readSome(char* data, std::size_t bytes)
+        {
+            if (stream != nullptr)
+                return static_cast<std::size_t>(stream->rdbuf()->sgetn(data, static_cast<std::streamsize>(bytes)));
+            std::size_t total = 0;
+#if AISDI_POSIX
+            while (total < bytes)
+            {
+                ssize_t got = ::read(fd, data + total, bytes - total);
+                if (got < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+                    throw std::system_error(errno, std::generic_category(), "Cannot read the container data");
+                }
+                if (got == 0)
+                    break;
+                total += static_cast<std::size_t>(got);
+            }
+#endif
+            return total;
+        }
+
+    public:
+        explicit BinaryReader(std::istream& stream_)
+            : stream(&stream_), fd(-1), position(0), filled(0)
+        {}
+
+#if AISDI_POSIX
+        explicit BinaryReader(int fd_)
+            : stream(nullptr), fd(fd_), buffer(new char[BufferBytes]), position(0), filled(0)
+        {}
+#endif
+
+        BinaryReader(const BinaryReader&) = delete;
+        BinaryReader& operator=(const BinaryReader&) = delete;
+
+        void read(void* destination, std::size_t bytes)
+        {
+            char* data = static_cast<char*>(destination);
+            if (stream != nullptr)
+            {
+                if (readSome(data, bytes) != bytes)
+                    truncated();
+                return;
+            }
+            std::size_t buffered = filled - position < bytes ? filled - position : bytes;
+            std::memcpy(data, buffer.get() + position, buffered);
+            position += buffered;
+            data += buffered;
+            bytes -= buffered;
+            if (bytes == 0)
+                return;
+            if (bytes >= BufferBytes)
+            {
+                if (readSome(data, bytes) != bytes)
+                    truncated();
+                return;
+            }
+            filled = readSome(buffer.get(), BufferBytes);
+            position = 0;
+            if (filled < bytes)
+                truncated();
+            std::memcpy(data, buffer.get(), bytes);
+            position = bytes;
+        }
+
+        void finish()
+        {
+#if AISDI_POSIX
+            if (stream == nullptr && position < filled)
+                ::lseek(fd, -static_cast<off_t>(filled - position), SEEK_CUR);
+#endif
+            position = filled = 0;
+        }
+    };
+
+    namespace serialization
+    {
+        const char Magic[8] = {'A', 'I', 'S', 'D', 'I', 'B', 'S', '1'};
+        const std::uint32_t ByteOrderMark = 0x01020304;
+        const std::uint64_t ChunkedCount = ~static_cast<std::uint64_t>(0);
+
+        struct Header
+        {
+            char magic[8];
+            std::uint32_t byteOrder;
+            std::uint32_t width;
+            std::uint64_t count;
+        };
+
+        template <typename Type>
+        void writeHeader(BinaryWriter& out, std::uint64_t count)
+        {
+            Header header;
+            std::memcpy(header.magic, Magic, sizeof(Magic));
+            header.byteOrder = ByteOrderMark;
+            header.width = BinaryCodec<Type>::width();
+            header.count = count;
+            out.write(&header, sizeof(header));
+        }
+
+        template <typename Type>
+        std::uint64_t readHeader(BinaryReader& in)
+        {
+            Header header;
+            in.read(&header, sizeof(header));
+            if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0)
+                throw std::runtime_error("This is not container data!");
+            if (header.byteOrder != ByteOrderMark)
+                throw std::runtime_error("The container data was written with another byte order!");
+            if (header.width != BinaryCodec<Type>::width())
+                throw std::runtime_error("The container data holds another element type!");
+            return header.count;
+        }
+
+        // Writes count elements from first on and returns where it stopped.
+        // Raw elements in contiguous memory go out as one block.
+        template <typename Iterator>
+        Iterator writeElements(BinaryWriter& out, Iterator first, std::size_t count)
+        {
+            typedef typename std::iterator_traits<Iterator>::value_type Type;
+            for (std::size_t i = 0; i < count; ++i, ++first)
+                BinaryCodec<Type>::write(out, *first);
+            return first;
+        }
+
+        template <typename Type>
+        const Type* writeElements(BinaryWriter& out, const Type* first, std::size_t count, std::true_type)
+        {
+            out.write(first, count * sizeof(Type));
+            return first + count;
+        }
+
+        template <typename Type>
+        const Type* writeElements(BinaryWriter& out, const Type* first, std::size_t count, std::false_type)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+                BinaryCodec<Type>::write(out, first[i]);
+            return first + count;
+        }
+
+        template <typename Type>
+        const Type* writeElements(BinaryWriter& out, const Type* first, std::size_t count)
+        {
+            return writeElements(out, first, count, std::integral_constant<bool, BinaryCodec<Type>::Raw>());
+        }
+
+        // Where the elements of a container start, for writeElements.
+        template <typename Type, typename GrowthPolicy, std::size_t InlineCapacity, typename Allocator>
+        const Type* elements(const Vector<Type, GrowthPolicy, InlineCapacity, Allocator>& vector_)
+        {
+            return vector_.data();
+        }
+
+        template <typename Type, template <typename, typename> class NodeStorage, typename Allocator>
+        typename LinkedList<Type, NodeStorage, Allocator>::const_iterator elements(const LinkedList<Type, NodeStorage, Allocator>& list)
+        {
+            return list.cbegin();
+        }
+    }
+
+    // Writes the chunked form one element or one run at a time. Elements
+    // given to append() are collected until chunkElements of them make a
+    // chunk; data without finish() reads back as cut short.
+    template <typename Type>
+    class ChunkedWriter
+    {
+    private:
+        BinaryWriter out;
+        Vector<Type> pending;
+        std::size_t chunkElements;
+
+        void writePending()
+        {
+            if (pending.isEmpty())
+                return;
+            std::uint64_t count = pending.getSize();
+            out.write(&count, sizeof(count));
+            serialization::writeElements(out, static_cast<const Type*>(pending.data()), pending.getSize());
+            pending.erase(pending.begin(), pending.end());
+        }
+
+    public:
+        static const std::size_t DefaultChunkElements = 4096;
+
+        explicit ChunkedWriter(std::ostream& stream, std::size_t chunkElements_ = DefaultChunkElements)
+            : out(stream), chunkElements(chunkElements_ == 0 ? 1 : chunkElements_)
+        {
+            serialization::writeHeader<Type>(out, serialization::ChunkedCount);
+        }
+
+#if AISDI_POSIX
+        explicit ChunkedWriter(int fd, std::size_t chunkElements_ = DefaultChunkElements)
+            : out(fd), chunkElements(chunkElements_ == 0 ? 1 : chunkElements_)
+        {
+            serialization::writeHeader<Type>(out, serialization::ChunkedCount);
+        }
+#endif
+
+        void append(const Type& item)
+        {
+            pending.append(item);
+            if (pending.getSize() >= chunkElements)
+                writePending();
+        }
+
+        // Writes count elements from first on as a chunk of their own,
+        // after those collected so far, and returns where it stopped.
+        template <typename Iterator>
+        Iterator appendChunk(Iterator first, std::size_t count)
+        {
+            writePending();
+            if (count == 0)
+                return first;
+            std::uint64_t length = count;
+            out.write(&length, sizeof(length));
+            return serialization::writeElements(out, first, count);
+        }
+
+        // Sends everything appended so far on to the stream or descriptor,
+        // where a ChunkedReader can already read it.
+        void flush()
+        {
+            writePending();
+            out.flush();
+        }
+
+        void finish()
+        {
+            writePending();
+            std::uint64_t end = 0;
+            out.write(&end, sizeof(end));
+            out.flush();
+        }
+    };
+
+    // Reads what save() or saveChunked() wrote, one element or one chunk
+    // at a time, without knowing the total in advance.
+    template <typename Type>
+    class ChunkedReader
+    {
+    private:
+        BinaryReader in;
+        bool chunked;
+        bool ended;
+        std::uint64_t remaining;
+
+        void start()
+        {
+            std::uint64_t count = serialization::readHeader<Type>(in);
+            chunked = count == serialization::ChunkedCount;
+            remaining = chunked ? 0 : count;
+            ended = false;
+        }
+
+    public:
+        explicit ChunkedReader(std::istream& stream)
+            : in(stream)
+        {
+            start();
+        }
+
+#if AISDI_POSIX
+        explicit ChunkedReader(int fd)
+            : in(fd)
+        {
+            start();
+        }
+#endif
+
+        // Elements left in the current chunk, moving on to the next chunk
+        // when this one is used up; 0 once the data has ended.
+        std::size_t available()
+        {
+            while (remaining == 0 && !ended)
+            {
+                std::uint64_t count = 0;
+                if (chunked)
+                    in.read(&count, sizeof(count));
+                if (count == 0)
+                {
+                    ended = true;
+                    in.finish();
+                }
+                remaining = count;
+            }
+            return static_cast<std::size_t>(remaining);
+        }
+
+        bool next(Type& item)
+        {
+            if (available() == 0)
+                return false;
+            BinaryCodec<Type>::read(in, item);
+            --remaining;
+            return true;
+        }
+
+        // Reads count raw elements, at most available(), into first.
+        void readBlock(Type* first, std::size_t count)
+        {
+            static_assert(BinaryCodec<Type>::Raw, "readBlock needs elements stored as their bytes!");
+            in.read(first, count * sizeof(Type));
+            remaining -= count;
+        }
+    };
+
+    namespace serialization
+    {
+        template <typename Type, typename GrowthPolicy, std::size_t InlineCapacity, typename Allocator>
+        void readChunk(Vector<Type, GrowthPolicy, InlineCapacity, Allocator>& vector_, ChunkedReader<Type>& in, std::size_t count, std::true_type)
+        {
+            vector_.appendOverwrite(count, [&in](Type* first, std::size_t elements) { in.readBlock(first, elements); });
+        }
+
+        template <typename Type, typename GrowthPolicy, std::size_t InlineCapacity, typename Allocator>
+        void readChunk(Vector<Type, GrowthPolicy, InlineCapacity, Allocator>& vector_, ChunkedReader<Type>& in, std::size_t count, std::false_type)
+        {
+            if (vector_.isEmpty())
+                vector_.reserve(count);
+            for (std::size_t i = 0; i < count; ++i)
+                in.next(vector_.emplaceBack());
+        }
+
+        template <typename Type, typename GrowthPolicy, std::size_t InlineCapacity, typename Allocator>
+        void loadFrom(Vector<Type, GrowthPolicy, InlineCapacity, Allocator>& vector_, ChunkedReader<Type>& in)
+        {
+            Vector<Type, GrowthPolicy, InlineCapacity, Allocator> loaded(vector_.getAllocator());
+            while (std::size_t count = in.available())
+                readChunk(loaded, in, readStep<Type>(count), std::integral_constant<bool, BinaryCodec<Type>::Raw>());
+            vector_ = std::move(loaded);
+        }
+
+        // Nodes are allocated a block of up to ReadStepBytes at a time, each
+        // before its elements are read.
+        template <typename Type, template <typename, typename> class NodeStorage, typename Allocator>
+        void loadFrom(LinkedList<Type, NodeStorage, Allocator>& list, ChunkedReader<Type>& in)
+        {
+            LinkedList<Type, NodeStorage, Allocator> loaded(list.getAllocator());
+            while (std::size_t count = readStep<Type>(in.available()))
+            {
+                loaded.reserve(count);
+                for (std::size_t i = 0; i < count; ++i)
+                    in.next(loaded.emplaceBack());
+            }
+            list = std::move(loaded);
+        }
+
+        template <typename Container>
+        void save(BinaryWriter& out, const Container& container)
+        {
+            writeHeader<typename Container::value_type>(out, container.getSize());
+            writeElements(out, elements(container), container.getSize());
+            out.flush();
+        }
+
+        template <typename Container>
+        void saveChunked(ChunkedWriter<typename Container::value_type>& out, const Container& container, std::size_t chunkElements)
+        {
+            auto first = elements(container);
+            for (std::size_t left = container.getSize(); left > 0;)
+            {
+                std::size_t count = left < chunkElements ? left : chunkElements;
+                first = out.appendChunk(first, count);
+                left -= count;
+            }
+            out.finish();
+        }
+    }
+
+    // save, saveChunked and load for Vector and LinkedList. load replaces
+    // the container's elements with the ones read, reads either form, and
+    // leaves the container as it was if it throws.
+
+    template <typename Container>
+    auto save(const Container& container, std::ostream& stream) -> decltype(serialization::elements(container), void())
+    {
+        BinaryWriter out(stream);
+        serialization::save(out, container);
+    }
+
+    template <typename Container>
+    auto saveChunked(const Container& container, std::ostream& stream,
+                     std::size_t chunkElements = ChunkedWriter<typename Container::value_type>::DefaultChunkElements)
+        -> decltype(serialization::elements(container), void())
+    {
+        ChunkedWriter<typename Container::value_type> out(stream, chunkElements);
+        serialization::saveChunked(out, container, chunkElements == 0 ? 1 : chunkElements);
+    }
+
+    template <typename Container>
+    auto load(Container& container, std::istream& stream) -> decltype(serialization::elements(container), void())
+    {
+        ChunkedReader<typename Container::value_type> in(stream);
+        serialization::loadFrom(container, in);
+    }
+
+#if AISDI_POSIX
+    template <typename Container>
+    auto save(const Container& container, int fd) -> decltype(serialization::elements(container), void())
+    {
+        BinaryWriter out(fd);
+        serialization::save(out, container);
+    }
+
+    template <typename Container>
+    auto saveChunked(const Container& container, int fd,
+                     std::size_t chunkElements = ChunkedWriter<typename Container::value_type>::DefaultChunkElements)
+        -> decltype(serialization::elements(container), void())
+    {
+        ChunkedWriter<typename Container::value_type> out(fd, chunkElements);
+        serialization::saveChunked(out, container, chunkElements == 0 ? 1 : chunkElements);
+    }
+
+    template <typename Container>
+    auto load(Container& container, int fd) -> decltype(serialization::elements(container), void())
+    {
+        ChunkedReader<typename Container::value_type> in(fd);
+        serialization::loadFrom(container, in);
+    }
+#endif
+
+}
+
+#endif // AISDI_LINEAR_SERIALIZATION_H
@@ -0,0 +1,708 @@
+#ifndef AISDI_LINEAR_SIMDKERNELS_H
+#define AISDI_LINEAR_SIMDKERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+#include "Config.h"
+#include "Vector.h"
+
+#if AISDI_SIMD
+// GCC 12 warns about the deliberately undefined vectors some AVX-512
+// intrinsics start from; the warnings point into this header.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#include <immintrin.h>
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+namespace aisdi
+{
+
+    // Instruction sets the kernels below are written for, weakest first.
+    enum class SimdLevel
+    {
+        Scalar,
+        Sse2,
+        Avx2,
+        Avx512
+    };
+
+    inline const char* simdLevelName(SimdLevel level)
+    {
+        switch (level)
+        {
+        case SimdLevel::Sse2:
+            return "sse2";
+        case SimdLevel::Avx2:
+            return "avx2";
+        case SimdLevel::Avx512:
+            return "avx512";
+        default:
+            return "scalar";
+        }
+    }
+
+    // The best level this CPU (and OS) runs; looked up once.
+    inline SimdLevel detectSimdLevel()
+    {
+#if AISDI_SIMD
+        static const SimdLevel level = []() -> SimdLevel {
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f"))
+                return SimdLevel::Avx512;
+            if (__builtin_cpu_supports("avx2"))
+                return SimdLevel::Avx2;
+            if (__builtin_cpu_supports("sse2"))
+                return SimdLevel::Sse2;
+            return SimdLevel::Scalar;
+        }();
+        return level;
+#else
+        return SimdLevel::Scalar;
+#endif
+    }
+
+    // Integers are summed in 64 bits, floating point in the element type.
+    template <typename T>
+    using SumType = typename std::conditional<std::is_floating_point<T>::value, T,
+            typename std::conditional<std::is_signed<T>::value, long long, unsigned long long>::type>::type;
+
+    namespace simd
+    {
+
+        // Reference versions, used for every other arithmetic type, below
+        // SSE2 and when AISDI_SIMD is 0.
+        namespace scalar
+        {
+            template <typename T>
+            std::size_t find(const T* data, std::size_t size, T value)
+            {
+                for (std::size_t i = 0; i < size; ++i)
+                    if (data[i] == value)
+                        return i;
+                return size;
+            }
+
+            template <typename T>
+            std::size_t count(const T* data, std::size_t size, T value)
+            {
+                std::size_t total = 0;
+                for (std::size_t i = 0; i < size; ++i)
+                    total += data[i] == value;
+                return total;
+            }
+
+            template <typename T>
+            T min(const T* data, std::size_t size)
+            {
+                T result = data[0];
+                for (std::size_t i = 1; i < size; ++i)
+                    if (data[i] < result)
+                        result = data[i];
+                return result;
+            }
+
+            template <typename T>
+            T max(const T* data, std::size_t size)
+            {
+                T result = data[0];
+                for (std::size_t i = 1; i < size; ++i)
+                    if (result < data[i])
+                        result = data[i];
+                return result;
+            }
+
+            template <typename T>
+            SumType<T> sum(const T* data, std::size_t size)
+            {
+                SumType<T> result = 0;
+                for (std::size_t i = 0; i < size; ++i)
+                    result += data[i];
+                return result;
+            }
+        }
+
+#if AISDI_SIMD
+
+// Everything between BEGIN and END is compiled for the given instruction
+// set only; it is called after detectSimdLevel() says the CPU has it.
+#if defined(__clang__)
+#define AISDI_SIMD_TARGET_END _Pragma("clang attribute pop")
+#else
+#define AISDI_SIMD_TARGET_END _Pragma("GCC pop_options")
+#endif
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("sse2"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+        namespace sse2
+        {
+            template <typename T>
+            struct Ops;
+
+            template <>
+            struct Ops<int>
+            {
+                typedef __m128i V;
+                typedef __m128i Sum;
+                static const std::size_t Lanes = 4;
+
+                static V load(const int* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+                static V splat(int value) { return _mm_set1_epi32(value); }
+                static unsigned equal(V a, V b) { return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, b))); }
+
+                // SSE2 has no 32-bit integer min/max; select through a mask.
+                static V min(V a, V b)
+                {
+                    V greater = _mm_cmpgt_epi32(a, b);
+                    return _mm_or_si128(_mm_and_si128(greater, b), _mm_andnot_si128(greater, a));
+                }
+
+                static V max(V a, V b)
+                {
+                    V greater = _mm_cmpgt_epi32(a, b);
+                    return _mm_or_si128(_mm_and_si128(greater, a), _mm_andnot_si128(greater, b));
+                }
+
+                static int reduceMin(V v)
+                {
+                    int lanes[Lanes];
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), v);
+                    return scalar::min(lanes, Lanes);
+                }
+
+                static int reduceMax(V v)
+                {
+                    int lanes[Lanes];
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), v);
+                    return scalar::max(lanes, Lanes);
+                }
+
+                static Sum zeroSum() { return _mm_setzero_si128(); }
+
+                // Sign-extends the four lanes to 64 bits before adding.
+                static Sum addSum(Sum sum, V v)
+                {
+                    V sign = _mm_cmpgt_epi32(_mm_setzero_si128(), v);
+                    return _mm_add_epi64(sum, _mm_add_epi64(_mm_unpacklo_epi32(v, sign), _mm_unpackhi_epi32(v, sign)));
+                }
+
+                static long long reduceSum(Sum sum)
+                {
+                    long long lanes[2];
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), sum);
+                    return lanes[0] + lanes[1];
+                }
+            };
+
+            template <>
+            struct Ops<float>
+            {
+                typedef __m128 V;
+                typedef __m128 Sum;
+                static const std::size_t Lanes = 4;
+
+                static V load(const float* p) { return _mm_loadu_ps(p); }
+                static V splat(float value) { return _mm_set1_ps(value); }
+                static unsigned equal(V a, V b) { return _mm_movemask_ps(_mm_cmpeq_ps(a, b)); }
+                static V min(V a, V b) { return _mm_min_ps(a, b); }
+                static V max(V a, V b) { return _mm_max_ps(a, b); }
+
+                static float reduceMin(V v)
+                {
+                    float lanes[Lanes];
+                    _mm_storeu_ps(lanes, v);
+                    return scalar::min(lanes, Lanes);
+                }
+
+                static float reduceMax(V v)
+                {
+                    float lanes[Lanes];
+                    _mm_storeu_ps(lanes, v);
+                    return scalar::max(lanes, Lanes);
+                }
+
+                static Sum zeroSum() { return _mm_setzero_ps(); }
+                static Sum addSum(Sum sum, V v) { return _mm_add_ps(sum, v); }
+
+                static float reduceSum(Sum sum)
+                {
+                    float lanes[Lanes];
+                    _mm_storeu_ps(lanes, sum);
+                    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+                }
+            };
+
+            template <>
+            struct Ops<double>
+            {
+                typedef __m128d V;
+                typedef __m128d Sum;
+                static const std::size_t Lanes = 2;
+
+                static V load(const double* p) { return _mm_loadu_pd(p); }
+                static V splat(double value) { return _mm_set1_pd(value); }
+                static unsigned equal(V a, V b) { return _mm_movemask_pd(_mm_cmpeq_pd(a, b)); }
+                static V min(V a, V b) { return _mm_min_pd(a, b); }
+                static V max(V a, V b) { return _mm_max_pd(a, b); }
+
+                static double reduceMin(V v)
+                {
+                    double lanes[Lanes];
+                    _mm_storeu_pd(lanes, v);
+                    return scalar::min(lanes, Lanes);
+                }
+
+                static double reduceMax(V v)
+                {
+                    double lanes[Lanes];
+                    _mm_storeu_pd(lanes, v);
+                    return scalar::max(lanes, Lanes);
+                }
+
+                static Sum zeroSum() { return _mm_setzero_pd(); }
+                static Sum addSum(Sum sum, V v) { return _mm_add_pd(sum, v); }
+
+                static double reduceSum(Sum sum)
+                {
+                    double lanes[Lanes];
+                    _mm_storeu_pd(lanes, sum);
+                    return lanes[0] + lanes[1];
+                }
+            };
+
+#include "SimdKernelsImpl.h"
+        }
+AISDI_SIMD_TARGET_END
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+        namespace avx2
+        {
+            template <typename T>
+            struct Ops;
+
+            template <>
+            struct Ops<int>
+            {
+                typedef __m256i V;
+                typedef __m256i Sum;
+                static const std::size_t Lanes = 8;
+
+                static V load(const int* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+                static V splat(int value) { return _mm256_set1_epi32(value); }
+                static unsigned equal(V a, V b) { return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b))); }
+                static V min(V a, V b) { return _mm256_min_epi32(a, b); }
+                static V max(V a, V b) { return _mm256_max_epi32(a, b); }
+
+                static int reduceMin(V v)
+                {
+                    int lanes[Lanes];
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), v);
+                    return scalar::min(lanes, Lanes);
+                }
+
+                static int reduceMax(V v)
+                {
+                    int lanes[Lanes];
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), v);
+                    return scalar::max(lanes, Lanes);
+                }
+
+                static Sum zeroSum() { return _mm256_setzero_si256(); }
+
+                static Sum addSum(Sum sum, V v)
+                {
+                    return _mm256_add_epi64(sum, _mm256_add_epi64(_mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)),
+                                                                  _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1))));
+                }
+
+                static long long reduceSum(Sum sum)
+                {
+                    long long lanes[4];
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), sum);
+                    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+                }
+            };
+
+            template <>
+            struct Ops<float>
+            {
+                typedef __m256 V;
+                typedef __m256 Sum;
+                static const std::size_t Lanes = 8;
+
+                static V load(const float* p) { return _mm256_loadu_ps(p); }
+                static V splat(float value) { return _mm256_set1_ps(value); }
+                static unsigned equal(V a, V b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ)); }
+                static V min(V a, V b) { return _mm256_min_ps(a, b); }
+                static V max(V a, V b) { return _mm256_max_ps(a, b); }
+
+                static float reduceMin(V v)
+                {
+                    float lanes[Lanes];
+                    _mm256_storeu_ps(lanes, v);
+                    return scalar::min(lanes, Lanes);
+                }
+
+                static float reduceMax(V v)
+                {
+                    float lanes[Lanes];
+                    _mm256_storeu_ps(lanes, v);
+                    return scalar::max(lanes, Lanes);
+                }
+
+                static Sum zeroSum() { return _mm256_setzero_ps(); }
+                static Sum addSum(Sum sum, V v) { return _mm256_add_ps(sum, v); }
+
+                static float reduceSum(Sum sum)
+                {
+                    float lanes[Lanes];
+                    _mm256_storeu_ps(lanes, sum);
+                    return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+                }
+            };
+
+            template <>
+            struct Ops<double>
+            {
+                typedef __m256d V;
+                typedef __m256d Sum;
+                static const std::size_t Lanes = 4;
+
+                static V load(const double* p) { return _mm256_loadu_pd(p); }
+                static V splat(double value) { return _mm256_set1_pd(value); }
+                static unsigned equal(V a, V b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ)); }
+                static V min(V a, V b) { return _mm256_min_pd(a, b); }
+                static V max(V a, V b) { return _mm256_max_pd(a, b); }
+
+                static double reduceMin(V v)
+                {
+                    double lanes[Lanes];
+                    _mm256_storeu_pd(lanes, v);
+                    return scalar::min(lanes, Lanes);
+                }
+
+                static double reduceMax(V v)
+                {
+                    double lanes[Lanes];
+                    _mm256_storeu_pd(lanes, v);
+                    return scalar::max(lanes, Lanes);
+                }
+
+                static Sum zeroSum() { return _mm256_setzero_pd(); }
+                static Sum addSum(Sum sum, V v) { return _mm256_add_pd(sum, v); }
+
+                static double reduceSum(Sum sum)
+                {
+                    double lanes[Lanes];
+                    _mm256_storeu_pd(lanes, sum);
+                    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+                }
+            };
+
+#include "SimdKernelsImpl.h"
+        }
+AISDI_SIMD_TARGET_END
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx512f"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#endif
+        namespace avx512
+        {
+            template <typename T>
+            struct Ops;
+
+            template <>
+            struct Ops<int>
+            {
+                typedef __m512i V;
+                typedef __m512i Sum;
+                static const std::size_t Lanes = 16;
+
+                static V load(const int* p) { return _mm512_loadu_si512(p); }
+                static V splat(int value) { return _mm512_set1_epi32(value); }
+                static unsigned equal(V a, V b) { return _mm512_cmpeq_epi32_mask(a, b); }
+                static V min(V a, V b) { return _mm512_min_epi32(a, b); }
+                static V max(V a, V b) { return _mm512_max_epi32(a, b); }
+                static int reduceMin(V v) { return _mm512_reduce_min_epi32(v); }
+                static int reduceMax(V v) { return _mm512_reduce_max_epi32(v); }
+                static Sum zeroSum() { return _mm512_setzero_si512(); }
+
+                static Sum addSum(Sum sum, V v)
+                {
+                    return _mm512_add_epi64(sum, _mm512_add_epi64(_mm512_cvtepi32_epi64(_mm512_castsi512_si256(v)),
+                                                                  _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(v, 1))));
+                }
+
+                static long long reduceSum(Sum sum) { return _mm512_reduce_add_epi64(sum); }
+            };
+
+            template <>
+            struct Ops<float>
+            {
+                typedef __m512 V;
+                typedef __m512 Sum;
+                static const std::size_t Lanes = 16;
+
+                static V load(const float* p) { return _mm512_loadu_ps(p); }
+                static V splat(float value) { return _mm512_set1_ps(value); }
+                static unsigned equal(V a, V b) { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+                static V min(V a, V b) { return _mm512_min_ps(a, b); }
+                static V max(V a, V b) { return _mm512_max_ps(a, b); }
+                static float reduceMin(V v) { return _mm512_reduce_min_ps(v); }
+                static float reduceMax(V v) { return _mm512_reduce_max_ps(v); }
+                static Sum zeroSum() { return _mm512_setzero_ps(); }
+                static Sum addSum(Sum sum, V v) { return _mm512_add_ps(sum, v); }
+                static float reduceSum(Sum sum) { return _mm512_reduce_add_ps(sum); }
+            };
+
+            template <>
+            struct Ops<double>
+            {
+                typedef __m512d V;
+                typedef __m512d Sum;
+                static const std::size_t Lanes = 8;
+
+                static V load(const double* p) { return _mm512_loadu_pd(p); }
+                static V splat(double value) { return _mm512_set1_pd(value); }
+                static unsigned equal(V a, V b) { return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ); }
+                static V min(V a, V b) { return _mm512_min_pd(a, b); }
+                static V max(V a, V b) { return _mm512_max_pd(a, b); }
+                static double reduceMin(V v) { return _mm512_reduce_min_pd(v); }
+                static double reduceMax(V v) { return _mm512_reduce_max_pd(v); }
+                static Sum zeroSum() { return _mm512_setzero_pd(); }
+                static Sum addSum(Sum sum, V v) { return _mm512_add_pd(sum, v); }
+                static double reduceSum(Sum sum) { return _mm512_reduce_add_pd(sum); }
+            };
+
+#include "SimdKernelsImpl.h"
+        }
+AISDI_SIMD_TARGET_END
+
+#undef AISDI_SIMD_TARGET_END
+
+#endif // AISDI_SIMD
+
+    }
+
+    // Kernels over raw arrays of Type, run with the given instruction set,
+    // which must not be above detectSimdLevel(). int, float and double
+    // have vector code; other arithmetic types always run the scalar loops.
+    // min and max skip NaN elements, except that a NaN first element makes
+    // the result NaN, at every level.
+    template <typename Type>
+    class SimdKernels
+    {
+    private:
+        using Vectorized = std::integral_constant<bool, AISDI_SIMD &&
+                (std::is_same<Type, int>::value || std::is_same<Type, float>::value || std::is_same<Type, double>::value)>;
+
+        static std::size_t find(const Type* data, std::size_t size, Type value, SimdLevel, std::false_type)
+        {
+            return simd::scalar::find(data, size, value);
+        }
+
+        static std::size_t count(const Type* data, std::size_t size, Type value, SimdLevel, std::false_type)
+        {
+            return simd::scalar::count(data, size, value);
+        }
+
+        static Type min(const Type* data, std::size_t size, SimdLevel, std::false_type)
+        {
+            return simd::scalar::min(data, size);
+        }
+
+        static Type max(const Type* data, std::size_t size, SimdLevel, std::false_type)
+        {
+            return simd::scalar::max(data, size);
+        }
+
+        static SumType<Type> sum(const Type* data, std::size_t size, SimdLevel, std::false_type)
+        {
+            return simd::scalar::sum(data, size);
+        }
+
+#if AISDI_SIMD
+        static std::size_t find(const Type* data, std::size_t size, Type value, SimdLevel level, std::true_type)
+        {
+            switch (level)
+            {
+            case SimdLevel::Avx512:
+                return simd::avx512::find(data, size, value);
+            case SimdLevel::Avx2:
+                return simd::avx2::find(data, size, value);
+            case SimdLevel::Sse2:
+                return simd::sse2::find(data, size, value);
+            default:
+                return simd::scalar::find(data, size, value);
+            }
+        }
+
+        static std::size_t count(const Type* data, std::size_t size, Type value, SimdLevel level, std::true_type)
+        {
+            switch (level)
+            {
+            case SimdLevel::Avx512:
+                return simd::avx512::count(data, size, value);
+            case SimdLevel::Avx2:
+                return simd::avx2::count(data, size, value);
+            case SimdLevel::Sse2:
+                return simd::sse2::count(data, size, value);
+            default:
+                return simd::scalar::count(data, size, value);
+            }
+        }
+
+        static Type min(const Type* data, std::size_t size, SimdLevel level, std::true_type)
+        {
+            switch (level)
+            {
+            case SimdLevel::Avx512:
+                return simd::avx512::min(data, size);
+            case SimdLevel::Avx2:
+                return simd::avx2::min(data, size);
+            case SimdLevel::Sse2:
+                return simd::sse2::min(data, size);
+            default:
+                return simd::scalar::min(data, size);
+            }
+        }
+
+        static Type max(const Type* data, std::size_t size, SimdLevel level, std::true_type)
+        {
+            switch (level)
+            {
+            case SimdLevel::Avx512:
+                return simd::avx512::max(data, size);
+            case SimdLevel::Avx2:
+                return simd::avx2::max(data, size);
+            case SimdLevel::Sse2:
+                return simd::sse2::max(data, size);
+            default:
+                return simd::scalar::max(data, size);
+            }
+        }
+
+        static SumType<Type> sum(const Type* data, std::size_t size, SimdLevel level, std::true_type)
+        {
+            switch (level)
+            {
+            case SimdLevel::Avx512:
+                return simd::avx512::sum(data, size);
+            case SimdLevel::Avx2:
+                return simd::avx2::sum(data, size);
+            case SimdLevel::Sse2:
+                return simd::sse2::sum(data, size);
+            default:
+                return simd::scalar::sum(data, size);
+            }
+        }
+#endif
+
+    public:
+        // Index of the first element equal to value, or size.
+        static std::size_t find(const Type* data, std::size_t size, Type value, SimdLevel level = detectSimdLevel())
+        {
+            return find(data, size, value, level, Vectorized());
+        }
+
+        static std::size_t count(const Type* data, std::size_t size, Type value, SimdLevel level = detectSimdLevel())
+        {
+            return count(data, size, value, level, Vectorized());
+        }
+
+        // min and max need size > 0.
+        static Type min(const Type* data, std::size_t size, SimdLevel level = detectSimdLevel())
+        {
+            return min(data, size, level, Vectorized());
+        }
+
+        static Type max(const Type* data, std::size_t size, SimdLevel level = detectSimdLevel())
+        {
+            return max(data, size, level, Vectorized());
+        }
+
+        // Floating-point sums are added in a different order than a plain
+        // loop would, so the last bits may differ from it.
+        static SumType<Type> sum(const Type* data, std::size_t size, SimdLevel level = detectSimdLevel())
+        {
+            return sum(data, size, level, Vectorized());
+        }
+    };
+
+    template <typename Type>
+    using RequireArithmetic = typename std::enable_if<std::is_arithmetic<Type>::value>::type;
+
+    // Vector algorithms for arithmetic element types, run by SimdKernels
+    // on the best instruction set of the CPU.
+
+    template <typename Type, typename GrowthPolicy, std::size_t InlineCapacity, typename Allocator, typename = RequireArithmetic<Type>>
+    typename Vector<Type, GrowthPolicy, InlineCapacity, Allocator>::const_iterator
+    find(const Vector<Type, GrowthPolicy, InlineCapacity, Allocator>& vector_, const typename Vector<Type, GrowthPolicy, InlineCapacity, Allocator>::value_type& value)
+    {
+        return vector_.cbegin() + SimdKernels<Type>::find(vector_.data(), vector_.getSize(), value);
+    }
+
+    // Position of the first element equal to value, or getSize().
+    template <typename Type, typename GrowthPolicy, std::size_t InlineCapacity, typename Allocator, typename = RequireArithmetic<Type>>
+    std::size_t indexOf(const Vector<Type, GrowthPolicy, InlineCapacity, Allocator>& vector_, const typename Vector<Type, GrowthPolicy, InlineCapacity, Allocator>::value_type& value)
+    {
+        return SimdKernels<Type>::find(vector_.data(), vector_.getSize(), value);
+    }
+
+    template <typename Type, typename GrowthPolicy, std::size_t InlineCapacity, typename Allocator, typename = RequireArithmetic<Type>>
+    bool contains(const Vector<Type, GrowthPolicy, InlineCapacity, Allocator>& vector_, const typename Vector<Type, GrowthPolicy, InlineCapacity, Allocator>::value_type& value)
+    {
+        return SimdKernels<Type>::find(vector_.data(), vector_.getSize(), value) != vector_.getSize();
+    }
+
+    template <typename Type, typename GrowthPolicy, std::size_t InlineCapacity, typename Allocator, typename = RequireArithmetic<Type>>
+    std::size_t count(const Vector<Type, GrowthPolicy, InlineCapacity, Allocator>& vector_, const typename Vector<Type, GrowthPolicy, InlineCapacity, Allocator>::value_type& value)
+    {
+        return SimdKernels<Type>::count(vector_.data(), vector_.getSize(), value);
+    }
+
+    template <typename Type, typename GrowthPolicy, std::size_t InlineCapacity, typename Allocator, typename = RequireArithmetic<Type>>
+    Type min(const Vector<Type, GrowthPolicy, InlineCapacity, Allocator>& vector_)
+    {
+        if (vector_.isEmpty())
+            throw std::logic_error("You are trying to take the minimum of an empty vector!");
+        return SimdKernels<Type>::min(vector_.data(), vector_.getSize());
+    }
+
+    template <typename Type, typename GrowthPolicy, std::size_t InlineCapacity, typename Allocator, typename = RequireArithmetic<Type>>
+    Type max(const Vector<Type, GrowthPolicy, InlineCapacity, Allocator>& vector_)
+    {
+        if (vector_.isEmpty())
+            throw std::logic_error("You are trying to take the maximum of an empty vector!");
+        return SimdKernels<Type>::max(vector_.data(), vector_.getSize());
+    }
+
+    template <typename Type, typename GrowthPolicy, std::size_t InlineCapacity, typename Allocator, typename = RequireArithmetic<Type>>
+    SumType<Type> sum(const Vector<Type, GrowthPolicy, InlineCapacity, Allocator>& vector_)
+    {
+        return SimdKernels<Type>::sum(vector_.data(), vector_.getSize());
+    }
+
+}
+
+#endif // AISDI_LINEAR_SIMDKERNELS_H
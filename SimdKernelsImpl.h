@@ -0,0 +1,127 @@
+// Kernels shared by every instruction set. SimdKernels.h includes this file
+// once per set, inside that set's namespace and target region, after
+// defining Ops<int>, Ops<float> and Ops<double> there. Ops<T> provides:
+//   V, Lanes                       vector type and elements per vector
+//   load(p), splat(value)          unaligned load, broadcast
+//   equal(a, b)                    bit i set when lane i is equal
+//   min(a, b), max(a, b)           lane-wise
+//   reduceMin(v), reduceMax(v)     across lanes
+//   Sum, zeroSum(), addSum(s, v)   accumulator of SumType<T>
+//   reduceSum(s)
+// No include guard on purpose.
+
+// Bit i of the result is set when element i of the four vectors at data
+// equals needle.
+template <typename T>
+inline std::uint64_t equalMask4(const T* data, const typename Ops<T>::V& needle)
+{
+    typedef Ops<T> O;
+    return static_cast<std::uint64_t>(O::equal(O::load(data), needle))
+           | static_cast<std::uint64_t>(O::equal(O::load(data + O::Lanes), needle)) << O::Lanes
+           | static_cast<std::uint64_t>(O::equal(O::load(data + 2 * O::Lanes), needle)) << 2 * O::Lanes
+           | static_cast<std::uint64_t>(O::equal(O::load(data + 3 * O::Lanes), needle)) << 3 * O::Lanes;
+}
+
+template <typename T>
+std::size_t find(const T* data, std::size_t size, T value)
+{
+    typedef Ops<T> O;
+    const typename O::V needle = O::splat(value);
+    std::size_t i = 0;
+    for (; i + 4 * O::Lanes <= size; i += 4 * O::Lanes)
+        if (std::uint64_t mask = equalMask4(data + i, needle))
+            return i + __builtin_ctzll(mask);
+    for (; i + O::Lanes <= size; i += O::Lanes)
+        if (unsigned mask = O::equal(O::load(data + i), needle))
+            return i + __builtin_ctz(mask);
+    for (; i < size; ++i)
+        if (data[i] == value)
+            return i;
+    return size;
+}
+
+template <typename T>
+std::size_t count(const T* data, std::size_t size, T value)
+{
+    typedef Ops<T> O;
+    const typename O::V needle = O::splat(value);
+    std::size_t total = 0;
+    std::size_t i = 0;
+    for (; i + 4 * O::Lanes <= size; i += 4 * O::Lanes)
+        total += __builtin_popcountll(equalMask4(data + i, needle));
+    for (; i < size; ++i)
+        total += data[i] == value;
+    return total;
+}
+
+// Four independent accumulators hide the latency of each min/max/add.
+// The float min/max instructions return their second operand when either
+// is NaN, so the accumulator goes second and a NaN element leaves it as it
+// was. The accumulators start from data[0]: if that is NaN every lane is,
+// and the result is NaN, just as in the scalar loops.
+template <typename T>
+T min(const T* data, std::size_t size)
+{
+    typedef Ops<T> O;
+    std::size_t i = 0;
+    T result = data[0];
+    if (size >= 4 * O::Lanes)
+    {
+        typename O::V a = O::splat(result), b = a, c = a, d = a;
+        for (; i + 4 * O::Lanes <= size; i += 4 * O::Lanes)
+        {
+            a = O::min(O::load(data + i), a);
+            b = O::min(O::load(data + i + O::Lanes), b);
+            c = O::min(O::load(data + i + 2 * O::Lanes), c);
+            d = O::min(O::load(data + i + 3 * O::Lanes), d);
+        }
+        result = O::reduceMin(O::min(O::min(a, b), O::min(c, d)));
+    }
+    for (; i < size; ++i)
+        if (data[i] < result)
+            result = data[i];
+    return result;
+}
+
+template <typename T>
+T max(const T* data, std::size_t size)
+{
+    typedef Ops<T> O;
+    std::size_t i = 0;
+    T result = data[0];
+    if (size >= 4 * O::Lanes)
+    {
+        typename O::V a = O::splat(result), b = a, c = a, d = a;
+        for (; i + 4 * O::Lanes <= size; i += 4 * O::Lanes)
+        {
+            a = O::max(O::load(data + i), a);
+            b = O::max(O::load(data + i + O::Lanes), b);
+            c = O::max(O::load(data + i + 2 * O::Lanes), c);
+            d = O::max(O::load(data + i + 3 * O::Lanes), d);
+        }
+        result = O::reduceMax(O::max(O::max(a, b), O::max(c, d)));
+    }
+    for (; i < size; ++i)
+        if (result < data[i])
+            result = data[i];
+    return result;
+}
+
+template <typename T>
+SumType<T> sum(const T* data, std::size_t size)
+{
+    typedef Ops<T> O;
+    typename O::Sum a = O::zeroSum(), b = O::zeroSum(), c = O::zeroSum(), d = O::zeroSum();
+    std::size_t i = 0;
+    for (; i + 4 * O::Lanes <= size; i += 4 * O::Lanes)
+    {
+        a = O::addSum(a, O::load(data + i));
+        b = O::addSum(b, O::load(data + i + O::Lanes));
+        c = O::addSum(c, O::load(data + i + 2 * O::Lanes));
+        d = O::addSum(d, O::load(data + i + 3 * O::Lanes));
+    }
+    SumType<T> result = O::reduceSum(a) + O::reduceSum(b) + O::reduceSum(c) + O::reduceSum(d);
+    for (; i < size; ++i)
+        result += data[i];
+    return result;
+}
@@ -0,0 +1,263 @@
+#ifndef AISDI_LINEAR_STATS_H
+#define AISDI_LINEAR_STATS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#include "Config.h"
+
+namespace aisdi
+{
+
+    // What a container did with memory and elements. Elements copied or
+    // moved are the ones the container moved about itself (reallocating,
+    // shifting, copying a whole container), not the ones handed to it.
+    // For lists, allocations and frees are nodes and the capacity is the
+    // number of elements.
+    struct ContainerStats
+    {
+        std::uint64_t allocations = 0;
+        std::uint64_t frees = 0;
+        std::uint64_t bytesAllocated = 0;
+        std::uint64_t bytesFreed = 0;
+        std::uint64_t reallocations = 0;
+        std::uint64_t elementsCopied = 0;
+        std::uint64_t elementsMoved = 0;
+        std::uint64_t peakCapacity = 0;
+
+        void writeJson(std::ostream& out) const
+        {
+            out << "{\"allocations\": " << allocations
+                << ", \"frees\": " << frees
+                << ", \"bytes_allocated\": " << bytesAllocated
+                << ", \"bytes_freed\": " << bytesFreed
+                << ", \"reallocations\": " << reallocations
+                << ", \"elements_copied\": " << elementsCopied
+                << ", \"elements_moved\": " << elementsMoved
+                << ", \"peak_capacity\": " << peakCapacity << "}";
+        }
+    };
+
+    enum class StatsFamily
+    {
+        Vector,
+        LinkedList
+    };
+
+    inline const char* statsFamilyName(StatsFamily family)
+    {
+        return family == StatsFamily::Vector ? "Vector" : "LinkedList";
+    }
+
+    // The totals of every container of a family, kept with relaxed atomics
+    // so containers on different threads can update them. The peak is the
+    // largest capacity any single container reached.
+    class GlobalStats
+    {
+    private:
+        std::atomic<std::uint64_t> allocations{0};
+        std::atomic<std::uint64_t> frees{0};
+        std::atomic<std::uint64_t> bytesAllocated{0};
+        std::atomic<std::uint64_t> bytesFreed{0};
+        std::atomic<std::uint64_t> reallocations{0};
+        std::atomic<std::uint64_t> elementsCopied{0};
+        std::atomic<std::uint64_t> elementsMoved{0};
+        std::atomic<std::uint64_t> peakCapacity{0};
+
+        static void add(std::atomic<std::uint64_t>& counter, std::uint64_t amount)
+        {
+            counter.fetch_add(amount, std::memory_order_relaxed);
+        }
+
+    public:
+        void recordAllocation(std::uint64_t bytes)
+        {
+            add(allocations, 1);
+            add(bytesAllocated, bytes);
+        }
+
+        void recordCapacity(std::uint64_t capacity)
+        {
+            std::uint64_t peak = peakCapacity.load(std::memory_order_relaxed);
+            while (capacity > peak && !peakCapacity.compare_exchange_weak(peak, capacity, std::memory_order_relaxed))
+            {}
+        }
+
+        void recordFree(std::uint64_t bytes)
+        {
+            add(frees, 1);
+            add(bytesFreed, bytes);
+        }
+
+        void recordReallocation()
+        {
+            add(reallocations, 1);
+        }
+
+        void recordCopies(std::uint64_t count)
+        {
+            add(elementsCopied, count);
+        }
+
+        void recordMoves(std::uint64_t count)
+        {
+            add(elementsMoved, count);
+        }
+
+        ContainerStats snapshot() const
+        {
+            ContainerStats stats;
+            stats.allocations = allocations.load(std::memory_order_relaxed);
+            stats.frees = frees.load(std::memory_order_relaxed);
+            stats.bytesAllocated = bytesAllocated.load(std::memory_order_relaxed);
+            stats.bytesFreed = bytesFreed.load(std::memory_order_relaxed);
+            stats.reallocations = reallocations.load(std::memory_order_relaxed);
+            stats.elementsCopied = elementsCopied.load(std::memory_order_relaxed);
+            stats.elementsMoved = elementsMoved.load(std::memory_order_relaxed);
+            stats.peakCapacity = peakCapacity.load(std::memory_order_relaxed);
+            return stats;
+        }
+
+        void reset()
+        {
+            for (auto counter : {&allocations, &frees, &bytesAllocated, &bytesFreed, &reallocations,
+                                 &elementsCopied, &elementsMoved, &peakCapacity})
+                counter->store(0, std::memory_order_relaxed);
+        }
+    };
+
+    inline GlobalStats& globalStats(StatsFamily family)
+    {
+        static GlobalStats stats[2];
+        return stats[static_cast<int>(family)];
+    }
+
+    // {"Vector": {...}, "LinkedList": {...}}, all zeros unless AISDI_STATS.
+    inline void writeGlobalStatsJson(std::ostream& out)
+    {
+        out << "{";
+        for (StatsFamily family : {StatsFamily::Vector, StatsFamily::LinkedList})
+        {
+            out << (family == StatsFamily::Vector ? "" : ", ") << "\"" << statsFamilyName(family) << "\": ";
+            globalStats(family).snapshot().writeJson(out);
+        }
+        out << "}";
+    }
+
+    // Counts for one container and its family. Containers derive from it,
+    // so when AISDI_STATS is off it is an empty base of no-op calls and
+    // costs neither space nor time. A copied or moved-to container starts
+    // from zero; assigning keeps the target's own counts.
+    template <StatsFamily Family, bool Enabled = AISDI_STATS>
+    class StatsRecorder
+    {
+    private:
+        ContainerStats stats;
+
+        static GlobalStats& global()
+        {
+            return globalStats(Family);
+        }
+
+    protected:
+        StatsRecorder()
+        {}
+
+        StatsRecorder(const StatsRecorder&)
+        {}
+
+        StatsRecorder& operator=(const StatsRecorder&)
+        {
+            return *this;
+        }
+
+        void recordAllocation(std::size_t bytes)
+        {
+            stats.allocations++;
+            stats.bytesAllocated += bytes;
+            global().recordAllocation(bytes);
+        }
+
+        void recordCapacity(std::size_t capacity)
+        {
+            if (capacity > stats.peakCapacity)
+            {
+                stats.peakCapacity = capacity;
+                global().recordCapacity(capacity);
+            }
+        }
+
+        void recordFree(std::size_t bytes)
+        {
+            stats.frees++;
+            stats.bytesFreed += bytes;
+            global().recordFree(bytes);
+        }
+
+        void recordReallocation()
+        {
+            stats.reallocations++;
+            global().recordReallocation();
+        }
+
+        void recordCopies(std::size_t count)
+        {
+            stats.elementsCopied += count;
+            global().recordCopies(count);
+        }
+
+        void recordMoves(std::size_t count)
+        {
+            stats.elementsMoved += count;
+            global().recordMoves(count);
+        }
+
+    public:
+        ContainerStats getStats() const
+        {
+            return stats;
+        }
+
+        void resetStats()
+        {
+            stats = ContainerStats();
+        }
+    };
+
+    template <StatsFamily Family>
+    class StatsRecorder<Family, false>
+    {
+    protected:
+        void recordAllocation(std::size_t)
+        {}
+
+        void recordCapacity(std::size_t)
+        {}
+
+        void recordFree(std::size_t)
+        {}
+
+        void recordReallocation()
+        {}
+
+        void recordCopies(std::size_t)
+        {}
+
+        void recordMoves(std::size_t)
+        {}
+
+    public:
+        ContainerStats getStats() const
+        {
+            return ContainerStats();
+        }
+
+        void resetStats()
+        {}
+    };
+
+}
+
+#endif // AISDI_LINEAR_STATS_H
@@ -0,0 +1,194 @@
+#ifndef AISDI_LINEAR_THREADPOOL_H
+#define AISDI_LINEAR_THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace aisdi
+{
+
+    // Fixed set of worker threads, each with its own task deque. A worker
+    // pushes and pops at the back of its own deque, so the tasks it spawns
+    // run while their data is still in its cache; idle workers steal from
+    // the front of the others', where the oldest and usually largest tasks
+    // are. Tasks submitted from outside the pool go to a shared queue.
+    //
+    // Threads waiting for their tasks should call runPendingTask() instead
+    // of blocking, so waiting inside a task cannot deadlock the pool, and a
+    // pool with no workers still makes progress. Exceptions escaping a task
+    // terminate the program; the parallel algorithms catch and forward them.
+    class ThreadPool
+    {
+    private:
+        struct TaskQueue
+        {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        struct WorkerContext
+        {
+            ThreadPool* pool;
+            std::size_t index;
+        };
+
+        // queues[i] belongs to worker i; the last one is the shared queue.
+        std::vector<std::unique_ptr<TaskQueue>> queues;
+        std::vector<std::thread> threads;
+        std::atomic<std::size_t> queued;
+        std::atomic<bool> stopping;
+        std::mutex sleepMutex;
+        std::condition_variable wake;
+
+        static WorkerContext& currentWorker()
+        {
+            static thread_local WorkerContext context = {nullptr, 0};
+            return context;
+        }
+
+        std::size_t ownQueue() const
+        {
+            const WorkerContext& context = currentWorker();
+            return context.pool == this ? context.index : threads.size();
+        }
+
+        bool popBack(TaskQueue& queue, std::function<void()>& task)
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.tasks.empty())
+                return false;
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            return true;
+        }
+
+        bool popFront(TaskQueue& queue, std::function<void()>& task)
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.tasks.empty())
+                return false;
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            return true;
+        }
+
+        bool takeTask(std::function<void()>& task)
+        {
+            if (queued.load(std::memory_order_acquire) == 0)
+                return false;
+            std::size_t own = ownQueue();
+            if (own < threads.size() && popBack(*queues[own], task))
+                return true;
+            if (popFront(*queues.back(), task))
+                return true;
+            for (std::size_t i = 1; i <= threads.size(); ++i)
+                if (popFront(*queues[(own + i) % threads.size()], task))
+                    return true;
+            return false;
+        }
+
+        void workerLoop(std::size_t index)
+        {
+            currentWorker() = WorkerContext{this, index};
+            for (;;)
+            {
+                if (runPendingTask())
+                    continue;
+                std::unique_lock<std::mutex> lock(sleepMutex);
+                wake.wait(lock, [this] { return stopping.load() || queued.load() > 0; });
+                if (stopping.load())
+                    return;
+            }
+        }
+
+    public:
+        // Zero threads leaves all the work to threads that wait for it.
+        explicit ThreadPool(std::size_t threadCount = std::thread::hardware_concurrency())
+            : queued(0), stopping(false)
+        {
+            for (std::size_t i = 0; i <= threadCount; ++i)
+                queues.emplace_back(new TaskQueue);
+            threads.reserve(threadCount);
+            try
+            {
+                for (std::size_t i = 0; i < threadCount; ++i)
+                    threads.emplace_back(&ThreadPool::workerLoop, this, i);
+            }
+            catch (...)
+            {
+                stop();
+                throw;
+            }
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        // Tasks still queued are dropped; submitters wait for theirs first.
+        ~ThreadPool()
+        {
+            stop();
+        }
+
+        void stop()
+        {
+            {
+                std::lock_guard<std::mutex> lock(sleepMutex);
+                stopping.store(true);
+            }
+            wake.notify_all();
+            for (auto& thread : threads)
+                if (thread.joinable())
+                    thread.join();
+        }
+
+        // Shared by the parallel algorithms when no pool is given; one
+        // worker per hardware thread.
+        static ThreadPool& defaultPool()
+        {
+            static ThreadPool pool;
+            return pool;
+        }
+
+        std::size_t getThreadCount() const
+        {
+            return threads.size();
+        }
+
+        void submit(std::function<void()> task)
+        {
+            TaskQueue& queue = *queues[ownQueue()];
+            {
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                queue.tasks.push_back(std::move(task));
+            }
+            queued.fetch_add(1, std::memory_order_release);
+            {
+                std::lock_guard<std::mutex> lock(sleepMutex);
+            }
+            wake.notify_one();
+        }
+
+        // Runs one queued task on the calling thread, if there is any.
+        bool runPendingTask()
+        {
+            std::function<void()> task;
+            if (!takeTask(task))
+                return false;
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            task();
+            return true;
+        }
+    };
+
+}
+
+#endif // AISDI_LINEAR_THREADPOOL_H
@@ -0,0 +1,745 @@
+#ifndef AISDI_LINEAR_UNROLLEDLIST_H
+#define AISDI_LINEAR_UNROLLEDLIST_H
+
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "Config.h"
+
+namespace aisdi
+{
+
+    // Elements per node so that a node takes about four cache lines.
+    template <typename Type>
+    struct UnrolledNodeCapacity
+    {
+        static const std::size_t NodeBytes = 256;
+        static const std::size_t Header = 2 * sizeof(void*) + sizeof(std::size_t);
+        static const std::size_t value = (NodeBytes - Header) / sizeof(Type) > 4 ? (NodeBytes - Header) / sizeof(Type) : 4;
+    };
+
+    // Doubly linked list of nodes that each hold up to NodeCapacity elements
+    // in a small array. Inserting or erasing at an iterator touches at most
+    // two nodes, so it stays O(1) in the list size; scans walk contiguous
+    // elements and follow a pointer only once per node. Elements occupy
+    // slots [Begin, End) of their node, so a node can grow or shrink at
+    // either end and shifts only the shorter side of a gap.
+    //
+    // Unlike LinkedList, inserting or erasing invalidates iterators into the
+    // node(s) it touches. Type's move constructor is expected not to throw.
+    template <typename Type, std::size_t NodeCapacity = UnrolledNodeCapacity<Type>::value>
+    class UnrolledList
+    {
+        static_assert(NodeCapacity >= 2, "UnrolledList nodes must hold at least two elements");
+
+public:
+        using difference_type = std::ptrdiff_t;
+        using size_type = std::size_t;
+        using value_type = Type;
+        using pointer = Type*;
+        using reference = Type&;
+        using const_pointer = const Type*;
+        using const_reference = const Type&;
+
+        class ConstIterator;
+        class Iterator;
+        using iterator = Iterator;
+        using const_iterator = ConstIterator;
+
+        static const size_type nodeCapacity = NodeCapacity;
+
+private:
+        // The sentinel is a bare, empty NodeBase with no successor.
+        struct NodeBase
+        {
+            NodeBase* Next = nullptr;
+            NodeBase* Prev = nullptr;
+            size_type Begin = 0;
+            size_type End = 0;
+
+            size_type count() const
+            {
+                return End - Begin;
+            }
+        };
+
+        struct Node : NodeBase
+        {
+            alignas(Type) unsigned char Storage[NodeCapacity * sizeof(Type)];
+        };
+
+        size_type Size;
+        size_type Nodes;
+        NodeBase* Head;
+        NodeBase* Tail;
+
+        static pointer values(NodeBase* Current)
+        {
+            return reinterpret_cast<pointer>(static_cast<Node*>(Current)->Storage);
+        }
+
+        using TriviallyCopyable = std::integral_constant<bool, std::is_trivially_copyable<value_type>::value>;
+
+        // Moves Count elements from Source into the raw slots at Destination
+        // and leaves the source slots raw; the ranges may overlap.
+        static void relocate(pointer Destination, pointer Source, size_type Count, std::true_type)
+        {
+            if (Count > 0 && Destination != Source)
+                std::memmove(static_cast<void*>(Destination), static_cast<const void*>(Source), Count * sizeof(Type));
+        }
+
+        static void relocate(pointer Destination, pointer Source, size_type Count, std::false_type)
+        {
+            if (Destination == Source)
+                return;
+            if (Destination < Source)
+                for (size_type i = 0; i < Count; ++i)
+                {
+                    new (Destination + i) Type(std::move(Source[i]));
+                    Source[i].~Type();
+                }
+            else
+                for (size_type i = Count; i > 0; --i)
+                {
+                    new (Destination + i - 1) Type(std::move(Source[i - 1]));
+                    Source[i - 1].~Type();
+                }
+        }
+
+        static void relocate(pointer Destination, pointer Source, size_type Count)
+        {
+            relocate(Destination, Source, Count, TriviallyCopyable());
+        }
+
+        static void destroy(pointer First, size_type Count)
+        {
+            if (!std::is_trivially_destructible<Type>::value)
+                for (size_type i = 0; i < Count; ++i)
+                    First[i].~Type();
+        }
+
+        // Links a new empty node in front of Position; its elements will
+        // start growing from Slot.
+        NodeBase* createNodeBefore(NodeBase* Position, size_type Slot)
+        {
+            NodeBase* NewNode = new Node;
+            NewNode->Begin = NewNode->End = Slot;
+            NewNode->Next = Position;
+            NewNode->Prev = Position->Prev;
+            if (Position == Head)
+                Head = NewNode;
+            else
+                Position->Prev->Next = NewNode;
+            Position->Prev = NewNode;
+            Nodes++;
+            return NewNode;
+        }
+
+        void destroyNode(NodeBase* Dead)
+        {
+            Dead->Next->Prev = Dead->Prev;
+            if (Dead == Head)
+                Head = Dead->Next;
+            else
+                Dead->Prev->Next = Dead->Next;
+            delete static_cast<Node*>(Dead);
+            Nodes--;
+        }
+
+        // Moves Item in front of Slot of a node that is not full, shifting
+        // the shorter side of the node that has room by one. Returns the
+        // slot Item ended up in.
+        size_type placeAt(NodeBase* Current, size_type Slot, Type&& Item)
+        {
+            pointer Values = values(Current);
+            size_type Begin = Current->Begin;
+            if (Begin > 0 && (Current->End == NodeCapacity || Slot - Begin < Current->End - Slot))
+            {
+                relocate(Values + Begin - 1, Values + Begin, Slot - Begin);
+                Current->Begin--;
+                --Slot;
+            }
+            else
+            {
+                relocate(Values + Slot + 1, Values + Slot, Current->End - Slot);
+                Current->End++;
+            }
+            new (Values + Slot) Type(std::move(Item));
+            return Slot;
+        }
+
+        // Builds the element in Slot of a new node linked in front of
+        // Position.
+        template <typename... Args>
+        ConstIterator emplaceInNewNode(NodeBase* Position, size_type Slot, Args&&... args)
+        {
+            NodeBase* NewNode = createNodeBefore(Position, Slot);
+            try
+            {
+                new (values(NewNode) + Slot) Type(std::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                destroyNode(NewNode);
+                throw;
+            }
+            NewNode->End++;
+            Size++;
+            return ConstIterator(NewNode, Slot);
+        }
+
+        // Places a new element in front of (Current, Slot) and returns where
+        // it ended up. Room at the end of the previous node is used first; a
+        // full node gets a fresh neighbour when the element goes in front of
+        // it and is split in half otherwise.
+        template <typename... Args>
+        ConstIterator emplaceBefore(NodeBase* Current, size_type Slot, Args&&... args)
+        {
+            if (Current->Next == nullptr)
+            {
+                NodeBase* Last = Current->Prev;
+                if (Last == nullptr || Last->End == NodeCapacity)
+                    return emplaceInNewNode(Current, 0, std::forward<Args>(args)...);
+                Current = Last;
+                Slot = Last->End;
+            }
+            else if (Slot == Current->Begin && Current->Prev != nullptr && Current->Prev->End < NodeCapacity)
+            {
+                Current = Current->Prev;
+                Slot = Current->End;
+            }
+            else if (Current->count() == NodeCapacity && Slot == 0)
+                return emplaceInNewNode(Current, NodeCapacity - 1, std::forward<Args>(args)...);
+
+            pointer Values = values(Current);
+            if (Slot == Current->End && Slot < NodeCapacity)
+            {
+                new (Values + Slot) Type(std::forward<Args>(args)...);
+                Current->End++;
+            }
+            else if (Slot == Current->Begin && Slot > 0)
+            {
+                new (Values + --Slot) Type(std::forward<Args>(args)...);
+                Current->Begin--;
+            }
+            else
+            {
+                // Built before any element moves, in case args alias one.
+                value_type Item(std::forward<Args>(args)...);
+                if (Current->count() == NodeCapacity)
+                {
+                    NodeBase* Upper = createNodeBefore(Current->Next, 0);
+                    size_type Half = NodeCapacity / 2;
+                    relocate(values(Upper), Values + Half, NodeCapacity - Half);
+                    Upper->End = NodeCapacity - Half;
+                    Current->End = Half;
+                    if (Slot > Half)
+                    {
+                        Current = Upper;
+                        Slot -= Half;
+                    }
+                }
+                Slot = placeAt(Current, Slot, std::move(Item));
+            }
+            Size++;
+            return ConstIterator(Current, Slot);
+        }
+
+        // Folds the next node into Current once both fit in half a node, so
+        // erasing keeps nodes reasonably full without splitting them again
+        // on the next insert.
+        void mergeWithNext(NodeBase* Current)
+        {
+            NodeBase* Next = Current->Next;
+            if (Next == nullptr || Next->Next == nullptr || Current->count() + Next->count() > NodeCapacity / 2)
+                return;
+            relocate(values(Current), values(Current) + Current->Begin, Current->count());
+            Current->End = Current->count();
+            Current->Begin = 0;
+            relocate(values(Current) + Current->End, values(Next) + Next->Begin, Next->count());
+            Current->End += Next->count();
+            destroyNode(Next);
+        }
+
+        template <typename InputIt>
+        using RequireInputIterator = typename std::enable_if<std::is_convertible<
+                typename std::iterator_traits<InputIt>::iterator_category, std::input_iterator_tag>::value>::type;
+
+public:
+        UnrolledList()
+        {
+            Head = Tail = new NodeBase;
+            Size = 0;
+            Nodes = 0;
+        }
+
+        UnrolledList(std::initializer_list<Type> l):UnrolledList()
+        {
+            append(l.begin(), l.end());
+        }
+
+        template <typename InputIt, typename = RequireInputIterator<InputIt>>
+        UnrolledList(InputIt first, InputIt last):UnrolledList()
+        {
+            append(first, last);
+        }
+
+        UnrolledList(const UnrolledList& other):UnrolledList()
+        {
+            *this = other;
+        }
+
+        UnrolledList(UnrolledList&& other):UnrolledList()
+        {
+            *this = std::move(other);
+        }
+
+        ~UnrolledList()
+        {
+            erase(begin(), end());
+            delete Tail;
+        }
+
+        UnrolledList& operator=(const UnrolledList& other)
+        {
+            if (this == &other)
+                return *this;
+
+            assign(other.begin(), other.end());
+
+            return *this;
+        }
+
+        UnrolledList& operator=(UnrolledList&& other)
+        {
+            if (this == &other)
+                return *this;
+
+            erase(begin(), end());
+            std::swap(Head, other.Head);
+            std::swap(Tail, other.Tail);
+            std::swap(Size, other.Size);
+            std::swap(Nodes, other.Nodes);
+
+            return *this;
+        }
+
+        bool isEmpty() const
+        {
+            return Size == 0;
+        }
+
+        size_type getSize() const
+        {
+            return Size;
+        }
+
+        size_type getNodeCount() const
+        {
+            return Nodes;
+        }
+
+        // Bytes held by the list, its sentinel and its nodes.
+        size_type getMemoryUsage() const
+        {
+            return sizeof(UnrolledList) + sizeof(NodeBase) + Nodes * sizeof(Node);
+        }
+
+        void append(const Type& item)
+        {
+            emplaceBefore(Tail, 0, item);
+        }
+
+        void append(Type&& item)
+        {
+            emplaceBefore(Tail, 0, std::move(item));
+        }
+
+        template <typename InputIt, typename = RequireInputIterator<InputIt>>
+        void append(InputIt first, InputIt last)
+        {
+            for (; first != last; ++first)
+                emplaceBefore(Tail, 0, *first);
+        }
+
+        void prepend(const Type& item)
+        {
+            emplaceBefore(Head, Head->Begin, item);
+        }
+
+        void prepend(Type&& item)
+        {
+            emplaceBefore(Head, Head->Begin, std::move(item));
+        }
+
+        void insert(const const_iterator& insertPosition, const Type& item)
+        {
+            emplace(insertPosition, item);
+        }
+
+        void insert(const const_iterator& insertPosition, Type&& item)
+        {
+            emplace(insertPosition, std::move(item));
+        }
+
+        template <typename InputIt, typename = RequireInputIterator<InputIt>>
+        void insert(const const_iterator& insertPosition, InputIt first, InputIt last)
+        {
+            const_iterator Position = insertPosition;
+            for (; first != last; ++first)
+                Position = ++emplace(Position, *first);
+        }
+
+        template <typename InputIt, typename = RequireInputIterator<InputIt>>
+        void assign(InputIt first, InputIt last)
+        {
+            erase(begin(), end());
+            append(first, last);
+        }
+
+        void assign(std::initializer_list<Type> l)
+        {
+            assign(l.begin(), l.end());
+        }
+
+        template <typename... Args>
+        reference emplaceBack(Args&&... args)
+        {
+            return const_cast<reference>(*emplaceBefore(Tail, 0, std::forward<Args>(args)...));
+        }
+
+        template <typename... Args>
+        reference emplaceFront(Args&&... args)
+        {
+            return const_cast<reference>(*emplaceBefore(Head, Head->Begin, std::forward<Args>(args)...));
+        }
+
+        template <typename... Args>
+        iterator emplace(const const_iterator& position, Args&&... args)
+        {
+            return iterator(emplaceBefore(position.nodePointer, position.index, std::forward<Args>(args)...));
+        }
+
+        Type popFirst()
+        {
+            if (Size == 0)
+                throw std::logic_error("No items to pop!");
+            auto Ret = std::move(values(Head)[Head->Begin]);
+            erase(begin());
+            return Ret;
+        }
+
+        Type popLast()
+        {
+            if (Size == 0)
+                throw std::logic_error("No items to pop!");
+            auto Ret = std::move(values(Tail->Prev)[Tail->Prev->End - 1]);
+            erase(ConstIterator(Tail->Prev, Tail->Prev->End - 1));
+            return Ret;
+        }
+
+        void erase(const const_iterator& possition)
+        {
+            if (possition == end())
+                throw std::out_of_range("Erasing end of list!");
+            erase(possition, possition + 1);
+        }
+
+        // Destroys the tail of the first node, every node in between and the
+        // front of the last one, then merges what is left of the two ends.
+        // Within a single node the gap is closed from its shorter side.
+        void erase(const const_iterator& firstIncluded, const const_iterator& lastExcluded)
+        {
+            if (firstIncluded == lastExcluded)
+                return;
+            if (firstIncluded == end())
+                throw std::out_of_range("Erasing end of list!");
+
+            NodeBase* First = firstIncluded.nodePointer;
+            NodeBase* Last = lastExcluded.nodePointer;
+            size_type From = firstIncluded.index;
+            size_type To = lastExcluded.index;
+            if (First == Last)
+            {
+                pointer Values = values(First);
+                destroy(Values + From, To - From);
+                if (From - First->Begin < First->End - To)
+                {
+                    relocate(Values + First->Begin + (To - From), Values + First->Begin, From - First->Begin);
+                    First->Begin += To - From;
+                }
+                else
+                {
+                    relocate(Values + From, Values + To, First->End - To);
+                    First->End -= To - From;
+                }
+                Size -= To - From;
+            }
+            else
+            {
+                destroy(values(First) + From, First->End - From);
+                Size -= First->End - From;
+                First->End = From;
+                while (First->Next != Last)
+                {
+                    NodeBase* Dead = First->Next;
+                    destroy(values(Dead) + Dead->Begin, Dead->count());
+                    Size -= Dead->count();
+                    destroyNode(Dead);
+                }
+                // The end sentinel is a bare NodeBase with no values.
+                if (Last != Tail)
+                {
+                    destroy(values(Last) + Last->Begin, To - Last->Begin);
+                    Size -= To - Last->Begin;
+                    Last->Begin = To;
+                }
+            }
+            NodeBase* Previous = First->Prev;
+            if (First->count() == 0)
+                destroyNode(First);
+            else
+                mergeWithNext(First);
+            if (Previous != nullptr)
+                mergeWithNext(Previous);
+        }
+
+        iterator begin()
+        {
+            return iterator(cbegin());
+        }
+
+        iterator end()
+        {
+            return iterator(cend());
+        }
+
+        const_iterator cbegin() const
+        {
+            return ConstIterator(Head, Head->Begin);
+        }
+
+        const_iterator cend() const
+        {
+            return ConstIterator(Tail, 0);
+        }
+
+        const_iterator begin() const
+        {
+            return cbegin();
+        }
+
+        const_iterator end() const
+        {
+            return cend();
+        }
+    };
+
+    template <typename Type, std::size_t NodeCapacity>
+    const typename UnrolledList<Type, NodeCapacity>::size_type UnrolledList<Type, NodeCapacity>::nodeCapacity;
+
+    template <typename Type, std::size_t NodeCapacity>
+    class UnrolledList<Type, NodeCapacity>::ConstIterator
+    {
+    public:
+        friend class UnrolledList;
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = typename UnrolledList::value_type;
+        using difference_type = typename UnrolledList::difference_type;
+        using pointer = typename UnrolledList::const_pointer;
+        using reference = typename UnrolledList::const_reference;
+
+    private:
+        // An element is a node and the slot it sits in; end() is slot 0 of
+        // the sentinel, the only node without a successor.
+        NodeBase* nodePointer;
+        size_type index;
+
+    public:
+        explicit ConstIterator(NodeBase* nodePointer_ = nullptr, size_type index_ = 0)
+        {
+            nodePointer = nodePointer_;
+            index = index_;
+        }
+
+        reference operator*() const
+        {
+#if AISDI_CHECKED_ITERATORS
+            if (nodePointer->Next == nullptr)
+                throw std::out_of_range("Dereferencing end of list!");
+#endif
+            return values(nodePointer)[index];
+        }
+
+        pointer operator->() const
+        {
+            return &**this;
+        }
+
+        ConstIterator& operator++()
+        {
+#if AISDI_CHECKED_ITERATORS
+            if (nodePointer->Next == nullptr)
+                throw std::out_of_range("Incrementing end of list!");
+#endif
+            if (++index == nodePointer->End)
+            {
+                nodePointer = nodePointer->Next;
+                index = nodePointer->Begin;
+            }
+            return *this;
+        }
+
+        ConstIterator operator++(int)
+        {
+            auto Ret = *this;
+            operator++();
+            return Ret;
+        }
+
+        ConstIterator& operator--()
+        {
+            if (index > nodePointer->Begin)
+            {
+                index--;
+                return *this;
+            }
+#if AISDI_CHECKED_ITERATORS
+            if (nodePointer->Prev == nullptr)
+                throw std::out_of_range("Decrementing begin of list!");
+#endif
+            nodePointer = nodePointer->Prev;
+            index = nodePointer->End - 1;
+            return *this;
+        }
+
+        ConstIterator operator--(int)
+        {
+            auto Ret = *this;
+            operator--();
+            return Ret;
+        }
+
+        // Whole nodes are skipped at once, so this is O(d / NodeCapacity).
+        ConstIterator operator+(difference_type d) const
+        {
+            if (d < 0)
+                return *this - (-d);
+            auto Ret = *this;
+            size_type Steps = static_cast<size_type>(d);
+            while (Steps > 0 && Ret.nodePointer->Next != nullptr && Steps >= Ret.nodePointer->End - Ret.index)
+            {
+                Steps -= Ret.nodePointer->End - Ret.index;
+                Ret.nodePointer = Ret.nodePointer->Next;
+                Ret.index = Ret.nodePointer->Begin;
+            }
+#if AISDI_CHECKED_ITERATORS
+            if (Steps > 0 && Ret.nodePointer->Next == nullptr)
+                throw std::out_of_range("Incrementing end of list!");
+#endif
+            Ret.index += Steps;
+            return Ret;
+        }
+
+        ConstIterator operator-(difference_type d) const
+        {
+            if (d < 0)
+                return *this + (-d);
+            auto Ret = *this;
+            size_type Steps = static_cast<size_type>(d);
+            while (Steps > Ret.index - Ret.nodePointer->Begin && Ret.nodePointer->Prev != nullptr)
+            {
+                Steps -= Ret.index - Ret.nodePointer->Begin + 1;
+                Ret.nodePointer = Ret.nodePointer->Prev;
+                Ret.index = Ret.nodePointer->End - 1;
+            }
+#if AISDI_CHECKED_ITERATORS
+            if (Steps > Ret.index - Ret.nodePointer->Begin)
+                throw std::out_of_range("Decrementing begin of list!");
+#endif
+            Ret.index -= Steps;
+            return Ret;
+        }
+
+        bool operator==(const ConstIterator& other) const
+        {
+            return nodePointer == other.nodePointer && index == other.index;
+        }
+
+        bool operator!=(const ConstIterator& other) const
+        {
+            return !(*this == other);
+        }
+    };
+
+    template <typename Type, std::size_t NodeCapacity>
+    class UnrolledList<Type, NodeCapacity>::Iterator : public UnrolledList<Type, NodeCapacity>::ConstIterator
+    {
+    public:
+        using pointer = typename UnrolledList::pointer;
+        using reference = typename UnrolledList::reference;
+
+        explicit Iterator()
+        {}
+
+        Iterator(const ConstIterator& other)
+                : ConstIterator(other)
+        {}
+
+        Iterator& operator++()
+        {
+            ConstIterator::operator++();
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            auto result = *this;
+            ConstIterator::operator++();
+            return result;
+        }
+
+        Iterator& operator--()
+        {
+            ConstIterator::operator--();
+            return *this;
+        }
+
+        Iterator operator--(int)
+        {
+            auto result = *this;
+            ConstIterator::operator--();
+            return result;
+        }
+
+        Iterator operator+(difference_type d) const
+        {
+            return ConstIterator::operator+(d);
+        }
+
+        Iterator operator-(difference_type d) const
+        {
+            return ConstIterator::operator-(d);
+        }
+
+        reference operator*() const
+        {
+            // ugly cast, yet reduces code duplication.
+            return const_cast<reference>(ConstIterator::operator*());
+        }
+
+        pointer operator->() const
+        {
+            return &**this;
+        }
+    };
+
+}
+
+#endif // AISDI_LINEAR_UNROLLEDLIST_H
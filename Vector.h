@@ -1,16 +1,132 @@
 #ifndef AISDI_LINEAR_VECTOR_H
 #define AISDI_LINEAR_VECTOR_H
 
+#include <algorithm>
+#include <climits>
 #include <cstddef>
+#include <cstring>
+#include <functional>
 #include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "Allocator.h"
+#include "Config.h"
+#include "Stats.h"
 
 namespace aisdi
 {
 
+    // Growth policies pick the capacity Vector reallocates to when it needs
+    // room for `required` elements. GrowthFactor<3, 2> grows by 1.5x, which
+    // lets freed blocks be reused by later growth; doubling reallocates less.
+    template <std::size_t Numerator, std::size_t Denominator = 1>
+    struct GrowthFactor
+    {
+        static_assert(Numerator > Denominator, "Growth factor has to be greater than 1!");
+
+        static std::size_t grow(std::size_t capacity, std::size_t required)
+        {
+            std::size_t grown = capacity == 0 ? 8 : capacity / Denominator * Numerator + capacity % Denominator * Numerator / Denominator;
+            if (grown <= capacity)
+                grown = capacity + 1;
+            return grown < required ? required : grown;
+        }
+    };
+
+    using DoublingGrowth = GrowthFactor<2>;
+
+    // LSD radix sort of the integers [first, last), a byte per pass, with
+    // room for as many in scratch. The counts for every byte are taken in
+    // one pass over the input, and a byte all keys share costs no pass.
+    template <typename Integer>
+    void radixSort(Integer* first, Integer* last, Integer* scratch)
+    {
+        typedef typename std::make_unsigned<Integer>::type Key;
+        const std::size_t Buckets = UCHAR_MAX + 1;
+        // Flipping the sign bit puts negative numbers first.
+        const Key signBit = std::is_signed<Integer>::value ? static_cast<Key>(Key(1) << (sizeof(Key) * CHAR_BIT - 1)) : Key(0);
+        const std::size_t size = static_cast<std::size_t>(last - first);
+        std::size_t counts[sizeof(Key)][Buckets] = {};
+        for (const Integer* item = first; item != last; ++item)
+        {
+            const Key key = static_cast<Key>(static_cast<Key>(*item) ^ signBit);
+            for (std::size_t byte = 0; byte < sizeof(Key); ++byte)
+                counts[byte][(key >> (byte * CHAR_BIT)) & UCHAR_MAX]++;
+        }
+        Integer* from = first;
+        Integer* to = scratch;
+        for (std::size_t byte = 0; byte < sizeof(Key); ++byte)
+        {
+            std::size_t* offsets = counts[byte];
+            const std::size_t shift = byte * CHAR_BIT;
+            if (size == 0 || offsets[(static_cast<Key>(static_cast<Key>(*from) ^ signBit) >> shift) & UCHAR_MAX] == size)
+                continue;
+            std::size_t offset = 0;
+            for (std::size_t bucket = 0; bucket < Buckets; ++bucket)
+            {
+                const std::size_t count = offsets[bucket];
+                offsets[bucket] = offset;
+                offset += count;
+            }
+            for (const Integer* item = from; item != from + size; ++item)
+                to[offsets[(static_cast<Key>(static_cast<Key>(*item) ^ signBit) >> shift) & UCHAR_MAX]++] = *item;
+            std::swap(from, to);
+        }
+        if (from != first)
+            std::memcpy(static_cast<void*>(first), static_cast<const void*>(from), size * sizeof(Integer));
+    }
+
+    // Room for InlineCapacity elements inside the Vector object itself.
+    template <typename Type, std::size_t InlineCapacity>
+    class VectorInlineStorage
+    {
+    private:
+        alignas(Type) unsigned char storage[InlineCapacity * sizeof(Type)];
+
+    protected:
+        Type* inlineData()
+        {
+            return reinterpret_cast<Type*>(storage);
+        }
+
+        const Type* inlineData() const
+        {
+            return reinterpret_cast<const Type*>(storage);
+        }
+    };
+
+    // Plain Vectors have no inline room and, through the empty base, pay
+    // nothing for it.
     template <typename Type>
-    class Vector
+    class VectorInlineStorage<Type, 0>
+    {
+    protected:
+        Type* inlineData()
+        {
+            return nullptr;
+        }
+
+        const Type* inlineData() const
+        {
+            return nullptr;
+        }
+    };
+
+    // With InlineCapacity > 0 the first InlineCapacity elements live inside
+    // the object and the heap is only touched once the vector outgrows
+    // them; see SmallVector below.
+    template <typename Type, typename GrowthPolicy = DoublingGrowth, std::size_t InlineCapacity = 0,
+              typename Allocator = std::allocator<Type>>
+    class Vector : private VectorInlineStorage<Type, InlineCapacity>, private AllocatorHolder<Allocator>,
+                   private StatsRecorder<StatsFamily::Vector>
     {
+        static_assert(std::is_same<typename Allocator::value_type, Type>::value, "The allocator has to allocate the element type!");
+
     public:
         using difference_type = std::ptrdiff_t;
         using size_type = std::size_t;
@@ -19,6 +135,7 @@ namespace aisdi
         using reference = Type&;
         using const_pointer = const Type*;
         using const_reference = const Type&;
+        using allocator_type = Allocator;
 
         class ConstIterator;
         class Iterator;
@@ -26,76 +143,679 @@ namespace aisdi
         using const_iterator = ConstIterator;
 
     private:
+        using Traits = std::allocator_traits<Allocator>;
+        using Propagation = AllocatorPropagation<Allocator>;
+        using Holder = AllocatorHolder<Allocator>;
+        using Holder::allocator;
+        using Recorder = StatsRecorder<StatsFamily::Vector>;
+
+        // Elements live in buffer[0, current_size). The allocation starts
+        // front slots before buffer, so both ends can grow without shifting.
         size_type current_size = 0;
-        size_type capacity = 8;
-        pointer buffer;
+        size_type capacity = InlineCapacity;
+        size_type front = 0;
+        pointer buffer = this->inlineData();
 
-    public:
-        Vector()
+        pointer allocate(size_type count)
         {
-            buffer = new value_type[capacity];
+            if (count == 0)
+                return nullptr;
+            pointer memory = Traits::allocate(allocator(), count);
+            this->recordAllocation(count * sizeof(value_type));
+            this->recordCapacity(count);
+            return memory;
         }
 
-        Vector(std::initializer_list<Type> l)
+        bool usesInlineStorage() const
         {
-            current_size = 0;
-            capacity = l.size();
-            buffer = new value_type[capacity];
-            for (auto i = l.begin(); i != l.end(); i++)
-                append(*i);
+            return buffer - front == this->inlineData();
         }
 
-        Vector(const Vector& other)
+        // Storage for a reallocation: the inline room when it fits and is
+        // not the storage being moved out of, otherwise the heap.
+        pointer allocateFor(size_type count)
         {
-            current_size = other.current_size;
-            capacity = other.capacity;
-            buffer = new value_type[capacity];
+            if (count <= InlineCapacity && !usesInlineStorage())
+                return this->inlineData();
+            return allocate(count);
+        }
 
-            for (size_type i = 0; i < current_size; i++)
-                buffer[i] = other.buffer[i];
+        size_type capacityOf(const_pointer storage, size_type count) const
+        {
+            return storage == this->inlineData() ? InlineCapacity : count;
         }
 
-        Vector(Vector&& other)
+        // count is the capacity memory was allocated with.
+        void deallocate(pointer memory, size_type count)
         {
-            current_size = other.current_size;
-            capacity = other.capacity;
-            if (this != &other)
+            if (memory != this->inlineData() && memory != nullptr)
+            {
+                Traits::deallocate(allocator(), memory, count);
+                this->recordFree(count * sizeof(value_type));
+            }
+        }
+
+        using TriviallyCopyable = std::integral_constant<bool, std::is_trivially_copyable<value_type>::value>;
+        using MoveIfNoexcept = std::integral_constant<bool,
+                std::is_nothrow_move_constructible<value_type>::value ||
+                !std::is_copy_constructible<value_type>::value>;
+        using RadixSortable = std::integral_constant<bool,
+                std::is_integral<value_type>::value && !std::is_same<value_type, bool>::value>;
+
+        // Below this many integers std::sort beats the radix passes.
+        static const size_type RadixThreshold = 256;
+
+        // Elements are built and torn down through the allocator, so one
+        // that passes itself on (std::pmr::polymorphic_allocator) reaches
+        // elements that take an allocator too.
+        template <typename... Args>
+        void construct(pointer slot, Args&&... args)
+        {
+            Traits::construct(allocator(), slot, std::forward<Args>(args)...);
+        }
+
+        void destroy(pointer item)
+        {
+            Traits::destroy(allocator(), item);
+        }
+
+        void destroy(pointer first, pointer last)
+        {
+            destroy(first, last, std::is_trivially_destructible<value_type>());
+        }
+
+        void destroy(pointer, pointer, std::true_type)
+        {}
+
+        void destroy(pointer first, pointer last, std::false_type)
+        {
+            for (; first != last; ++first)
+                destroy(first);
+        }
+
+        // Builds [first, last) into raw memory at dest; on failure the
+        // elements built so far are destroyed again.
+        template <typename InputIt>
+        pointer constructFrom(InputIt first, InputIt last, pointer dest)
+        {
+            pointer current = dest;
+            try
+            {
+                for (; first != last; ++first, ++current)
+                    construct(current, *first);
+            }
+            catch (...)
+            {
+                destroy(dest, current);
+                throw;
+            }
+            return current;
+        }
+
+        // Trivially copyable elements are plain bytes: every copy, move and
+        // shift below becomes a single memcpy/memmove for them, whatever the
+        // allocator, as building one can do nothing but copy its bytes.
+        static pointer copyBytes(const_pointer first, const_pointer last, pointer dest)
+        {
+            if (first != last)
+                std::memcpy(static_cast<void*>(dest), static_cast<const void*>(first), (last - first) * sizeof(value_type));
+            return dest + (last - first);
+        }
+
+        // Copies [first, last) into raw memory at dest.
+        pointer copyConstruct(const_pointer first, const_pointer last, pointer dest)
+        {
+            this->recordCopies(last - first);
+            return copyConstruct(first, last, dest, TriviallyCopyable());
+        }
+
+        pointer copyConstruct(const_pointer first, const_pointer last, pointer dest, std::true_type)
+        {
+            return copyBytes(first, last, dest);
+        }
+
+        pointer copyConstruct(const_pointer first, const_pointer last, pointer dest, std::false_type)
+        {
+            return constructFrom(first, last, dest);
+        }
+
+        // Moves [first, last) into raw memory at dest. Falls back to copying
+        // when a throwing move would lose elements, like std::move_if_noexcept.
+        pointer relocate(pointer first, pointer last, pointer dest)
+        {
+            return relocate(first, last, dest, TriviallyCopyable(), MoveIfNoexcept());
+        }
+
+        template <typename Move>
+        pointer relocate(pointer first, pointer last, pointer dest, std::true_type, Move)
+        {
+            this->recordMoves(last - first);
+            return copyBytes(first, last, dest);
+        }
+
+        pointer relocate(pointer first, pointer last, pointer dest, std::false_type, std::true_type)
+        {
+            this->recordMoves(last - first);
+            return constructFrom(std::make_move_iterator(first), std::make_move_iterator(last), dest);
+        }
+
+        pointer relocate(pointer first, pointer last, pointer dest, std::false_type, std::false_type)
+        {
+            this->recordCopies(last - first);
+            return constructFrom(first, last, dest);
+        }
+
+        // Moves the live elements [first, last) onto live slots at dest; the
+        // two ranges may overlap.
+        void shiftElements(pointer first, pointer last, pointer dest)
+        {
+            this->recordMoves(last - first);
+            shiftElements(first, last, dest, TriviallyCopyable());
+        }
+
+        static void shiftElements(pointer first, pointer last, pointer dest, std::true_type)
+        {
+            if (first != last)
+                std::memmove(static_cast<void*>(dest), static_cast<const void*>(first), (last - first) * sizeof(value_type));
+        }
+
+        static void shiftElements(pointer first, pointer last, pointer dest, std::false_type)
+        {
+            if (dest < first)
+                std::move(first, last, dest);
+            else
+                std::move_backward(first, last, dest + (last - first));
+        }
+
+        size_type positionOf(const const_iterator& it) const
+        {
+            return static_cast<size_type>(it.element - buffer);
+        }
+
+        size_type backRoom() const
+        {
+            return capacity - front - current_size;
+        }
+
+        void releaseStorage()
+        {
+            destroy(buffer, buffer + current_size);
+            deallocate(buffer - front, capacity);
+        }
+
+        void resetStorage()
+        {
+            releaseStorage();
+            current_size = 0;
+            capacity = InlineCapacity;
+            front = 0;
+            buffer = this->inlineData();
+        }
+
+        // Takes other's elements into this vector, which must hold none and
+        // use its inline storage; other is left empty. Heap buffers change
+        // hands, inline elements have to be moved one by one.
+        void takeStorage(Vector& other)
+        {
+            if (!other.usesInlineStorage())
             {
+                current_size = other.current_size;
+                capacity = other.capacity;
+                front = other.front;
                 buffer = other.buffer;
-                other.buffer = nullptr;
+            }
+            else
+            {
+                relocate(other.buffer, other.buffer + other.current_size, buffer);
+                destroy(other.buffer, other.buffer + other.current_size);
+                current_size = other.current_size;
+            }
+            other.current_size = 0;
+            other.capacity = InlineCapacity;
+            other.front = 0;
+            other.buffer = other.inlineData();
+        }
+
+        void initStorage(size_type count)
+        {
+            if (count > InlineCapacity)
+            {
+                buffer = allocate(count);
+                capacity = count;
+            }
+        }
+
+        // other's storage goes to this vector and ours to other, each with
+        // the allocator it came from.
+        void swapWith(Vector& other, std::true_type)
+        {
+            Vector temp(std::move(other));
+            Propagation::swapOnSwap(allocator(), other.allocator());
+            other.takeStorage(*this);
+            takeStorage(temp);
+        }
+
+        // Without propagation the moves take buffers where the allocators
+        // compare equal and move the elements where they do not.
+        void swapWith(Vector& other, std::false_type)
+        {
+            Vector temp(std::move(other));
+            other = std::move(*this);
+            *this = std::move(temp);
+        }
+
+        // Fills this empty, freshly constructed vector with copies of count
+        // elements.
+        void copyFrom(const_pointer first, size_type count)
+        {
+            initStorage(count);
+            try
+            {
+                copyConstruct(first, first + count, buffer);
+            }
+            catch (...)
+            {
+                deallocate(buffer, capacity);
+                throw;
+            }
+            current_size = count;
+        }
+
+        void reallocate(size_type new_capacity)
+        {
+            pointer new_buffer = allocateFor(new_capacity);
+            try
+            {
+                relocate(buffer, buffer + current_size, new_buffer);
+            }
+            catch (...)
+            {
+                deallocate(new_buffer, new_capacity);
+                throw;
+            }
+            if (current_size > 0)
+                this->recordReallocation();
+            releaseStorage();
+            buffer = new_buffer;
+            capacity = capacityOf(new_buffer, new_capacity);
+            front = 0;
+        }
+
+        // Moves the elements to start new_front slots into the allocation.
+        // Callers guarantee the old and new ranges do not overlap.
+        void slide(size_type new_front)
+        {
+            pointer new_buffer = buffer - front + new_front;
+            relocate(buffer, buffer + current_size, new_buffer);
+            destroy(buffer, buffer + current_size);
+            buffer = new_buffer;
+            front = new_front;
+        }
+
+        // Moves the elements into new_buffer, leaving `gap` raw slots at
+        // index. On failure nothing has been moved out of the old buffer.
+        void relocateAround(pointer new_buffer, size_type index, size_type gap)
+        {
+            relocate(buffer, buffer + index, new_buffer);
+            try
+            {
+                relocate(buffer + index, buffer + current_size, new_buffer + index + gap);
+            }
+            catch (...)
+            {
+                destroy(new_buffer, new_buffer + index);
+                throw;
+            }
+        }
+
+        void adoptStorage(pointer new_storage, size_type new_capacity, size_type new_front, size_type added)
+        {
+            if (current_size > 0)
+                this->recordReallocation();
+            releaseStorage();
+            buffer = new_storage + new_front;
+            capacity = capacityOf(new_storage, new_capacity);
+            front = new_front;
+            current_size += added;
+        }
+
+        // The new element is built in the new buffer before the old one is
+        // torn down, so args may refer to elements of this vector. Growing at
+        // the front hands all the new room to the front, otherwise to the back.
+        template <typename... Args>
+        void growAndEmplace(size_type index, bool atFront, Args&&... args)
+        {
+            size_type new_capacity = GrowthPolicy::grow(capacity, current_size + 1);
+            size_type new_front = atFront ? new_capacity - current_size - 1 - backRoom() : front;
+            pointer new_storage = allocateFor(new_capacity);
+            pointer slot = new_storage + new_front + index;
+            try
+            {
+                construct(slot, std::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                deallocate(new_storage, new_capacity);
+                throw;
+            }
+            try
+            {
+                relocateAround(new_storage + new_front, index, 1);
+            }
+            catch (...)
+            {
+                destroy(slot);
+                deallocate(new_storage, new_capacity);
+                throw;
+            }
+            adoptStorage(new_storage, new_capacity, new_front, 1);
+        }
+
+        // Called when the end being pushed to is full. If the opposite end
+        // has room for twice the elements, they slide over to the middle of
+        // the free space instead of reallocating; either way every slot
+        // moved buys at least one more push, which keeps both ends O(1).
+        template <typename... Args>
+        void emplaceAtFullEnd(bool atFront, Args&&... args)
+        {
+            size_type room = atFront ? backRoom() : front;
+            if (room < 2 * current_size + 2)
+            {
+                growAndEmplace(atFront ? 0 : current_size, atFront, std::forward<Args>(args)...);
+                return;
+            }
+            // Built before sliding, in case args alias a moved element.
+            value_type item(std::forward<Args>(args)...);
+            slide(atFront ? room / 2 : front - room / 2);
+            if (atFront)
+            {
+                construct(buffer - 1, std::move(item));
+                buffer--;
+                front--;
+            }
+            else
+                construct(buffer + current_size, std::move(item));
+            current_size++;
+        }
+
+        template <typename... Args>
+        void emplaceAt(size_type index, Args&&... args)
+        {
+            if (index == current_size && backRoom() > 0)
+            {
+                construct(buffer + current_size, std::forward<Args>(args)...);
+                current_size++;
+            }
+            else if (index == 0 && front > 0)
+            {
+                construct(buffer - 1, std::forward<Args>(args)...);
+                buffer--;
+                front--;
+                current_size++;
+            }
+            else if (index == current_size || index == 0)
+                emplaceAtFullEnd(index == 0 && current_size > 0, std::forward<Args>(args)...);
+            else if (backRoom() > 0 && (front == 0 || index >= current_size / 2))
+            {
+                // Built before shifting, in case args alias a shifted element.
+                value_type item(std::forward<Args>(args)...);
+                construct(buffer + current_size, std::move(buffer[current_size - 1]));
+                this->recordMoves(1);
+                current_size++;
+                shiftElements(buffer + index, buffer + current_size - 2, buffer + index + 1);
+                buffer[index] = std::move(item);
+            }
+            else if (front > 0)
+            {
+                value_type item(std::forward<Args>(args)...);
+                construct(buffer - 1, std::move(buffer[0]));
+                this->recordMoves(1);
+                buffer--;
+                front--;
+                current_size++;
+                shiftElements(buffer + 2, buffer + index + 1, buffer + 1);
+                buffer[index] = std::move(item);
+            }
+            else
+                growAndEmplace(index, false, std::forward<Args>(args)...);
+        }
+
+        template <typename InputIt>
+        using RequireInputIterator = typename std::enable_if<std::is_convertible<
+                typename std::iterator_traits<InputIt>::iterator_category, std::input_iterator_tag>::value>::type;
+
+        template <typename InputIt>
+        void insertRange(size_type index, InputIt first, InputIt last, std::input_iterator_tag)
+        {
+            Vector items(allocator());
+            for (; first != last; ++first)
+                items.emplaceAt(items.current_size, *first);
+            insertRange(index, std::make_move_iterator(items.buffer),
+                        std::make_move_iterator(items.buffer + items.current_size), std::forward_iterator_tag());
+        }
+
+        // Inserts the whole range with at most one reallocation; the tail is
+        // shifted once by the range length. The range must not come from
+        // this vector.
+        template <typename ForwardIt>
+        void insertRange(size_type index, ForwardIt first, ForwardIt last, std::forward_iterator_tag)
+        {
+            size_type count = std::distance(first, last);
+            if (count == 0)
+                return;
+            if (index == 0 && front >= count)
+            {
+                constructFrom(first, last, buffer - count);
+                buffer -= count;
+                front -= count;
+                current_size += count;
+            }
+            else if (backRoom() >= count)
+                shiftAndInsert(index, first, last, count);
+            else
+                growAndInsert(index, first, last, count);
+        }
+
+        template <typename ForwardIt>
+        void shiftAndInsert(size_type index, ForwardIt first, ForwardIt last, size_type count)
+        {
+            pointer position = buffer + index;
+            pointer old_end = buffer + current_size;
+            size_type tail = current_size - index;
+            if (tail > count)
+            {
+                relocate(old_end - count, old_end, old_end);
+                current_size += count;
+                shiftElements(position, old_end - count, position + count);
+                std::copy(first, last, position);
+            }
+            else
+            {
+                ForwardIt mid = first;
+                std::advance(mid, tail);
+                constructFrom(mid, last, old_end);
+                try
+                {
+                    relocate(position, old_end, position + count);
+                }
+                catch (...)
+                {
+                    destroy(old_end, position + count);
+                    throw;
+                }
+                current_size += count;
+                std::copy(first, mid, position);
+            }
+        }
+
+        template <typename ForwardIt>
+        void growAndInsert(size_type index, ForwardIt first, ForwardIt last, size_type count)
+        {
+            size_type new_capacity = GrowthPolicy::grow(capacity, current_size + count);
+            pointer new_storage = allocateFor(new_capacity);
+            pointer slot = new_storage + index;
+            try
+            {
+                constructFrom(first, last, slot);
+            }
+            catch (...)
+            {
+                deallocate(new_storage, new_capacity);
+                throw;
+            }
+            try
+            {
+                relocateAround(new_storage, index, count);
+            }
+            catch (...)
+            {
+                destroy(slot, slot + count);
+                deallocate(new_storage, new_capacity);
+                throw;
+            }
+            adoptStorage(new_storage, new_capacity, 0, count);
+        }
+
+        void sortAscending(std::true_type)
+        {
+            if (current_size < RadixThreshold)
+            {
+                std::sort(buffer, buffer + current_size);
+                return;
+            }
+            pointer scratch = allocate(current_size);
+            radixSort(buffer, buffer + current_size, scratch);
+            deallocate(scratch, current_size);
+        }
+
+        void sortAscending(std::false_type)
+        {
+            sort(std::less<Type>());
+        }
+
+    public:
+        // Allocates nothing until the first element is added.
+        Vector() : Holder(Allocator())
+        {}
+
+        explicit Vector(const Allocator& allocator_) : Holder(allocator_)
+        {}
+
+        Vector(std::initializer_list<Type> l, const Allocator& allocator_ = Allocator()) : Holder(allocator_)
+        {
+            copyFrom(l.begin(), l.size());
+        }
+
+        template <typename InputIt, typename = RequireInputIterator<InputIt>>
+        Vector(InputIt first, InputIt last, const Allocator& allocator_ = Allocator()) : Holder(allocator_)
+        {
+            append(first, last);
+        }
+
+        // The copy gets the allocator select_on_container_copy_construction
+        // picks, or the one given.
+        Vector(const Vector& other) : Holder(Propagation::copyFor(other.allocator())), Recorder()
+        {
+            copyFrom(other.buffer, other.current_size);
+        }
+
+        Vector(const Vector& other, const Allocator& allocator_) : Holder(allocator_)
+        {
+            copyFrom(other.buffer, other.current_size);
+        }
+
+        // Only throws when inline elements have to be copied across.
+        Vector(Vector&& other) noexcept(InlineCapacity == 0 || std::is_nothrow_move_constructible<Type>::value)
+            : Holder(std::move(other.allocator()))
+        {
+            takeStorage(other);
+        }
+
+        // Takes other's buffer when allocator_ can free it, otherwise moves
+        // the elements one by one into a buffer of allocator_.
+        Vector(Vector&& other, const Allocator& allocator_) : Holder(allocator_)
+        {
+            if (allocator() == other.allocator())
+                takeStorage(other);
+            else
+            {
+                this->recordMoves(other.current_size);
+                append(std::make_move_iterator(other.buffer), std::make_move_iterator(other.buffer + other.current_size));
             }
         }
 
         ~Vector()
         {
-            delete[] buffer;
+            releaseStorage();
         }
 
         Vector& operator=(const Vector& other)
         {
             if (this == &other)
                 return *this;
-            current_size = other.current_size;
-            capacity = other.capacity;
-            delete[] buffer;
-            buffer = new value_type[capacity];
-            for (size_type i = 0; i < current_size; i++)
-                buffer[i] = other.buffer[i];
+            // Our buffer has to go back to our allocator before it is replaced.
+            if (Propagation::OnCopy::value && !(allocator() == other.allocator()))
+                resetStorage();
+            Propagation::assignOnCopy(allocator(), other.allocator());
+            if (other.current_size > capacity - front)
+            {
+                Vector copy(other, allocator());
+                resetStorage();
+                takeStorage(copy);
+            }
+            else if (other.current_size <= current_size)
+            {
+                this->recordCopies(other.current_size);
+                std::copy(other.buffer, other.buffer + other.current_size, buffer);
+                destroy(buffer + other.current_size, buffer + current_size);
+                current_size = other.current_size;
+            }
+            else
+            {
+                this->recordCopies(current_size);
+                std::copy(other.buffer, other.buffer + current_size, buffer);
+                copyConstruct(other.buffer + current_size, other.buffer + other.current_size, buffer + current_size);
+                current_size = other.current_size;
+            }
             return *this;
         }
 
+        // With allocators that neither propagate nor compare equal the
+        // buffer cannot change hands, so the elements are moved over.
         Vector& operator=(Vector&& other)
         {
             if (this == &other)
                 return *this;
-            current_size = other.current_size;
-            capacity = other.capacity;
-            delete[] buffer;
-            buffer = other.buffer;
-            other.buffer = nullptr;
+            if (!Propagation::canMove(allocator(), other.allocator()))
+            {
+                this->recordMoves(other.current_size);
+                assign(std::make_move_iterator(other.buffer), std::make_move_iterator(other.buffer + other.current_size));
+                return *this;
+            }
+            resetStorage();
+            Propagation::assignOnMove(allocator(), other.allocator());
+            takeStorage(other);
             return *this;
         }
 
+        // O(1) unless inline elements are involved or the allocators can
+        // neither be swapped nor free each other's buffers; then the
+        // elements are moved across.
+        void swap(Vector& other)
+        {
+            if (this != &other)
+                swapWith(other, typename Propagation::OnSwap());
+        }
+
+        allocator_type getAllocator() const
+        {
+            return allocator();
+        }
+
+        // Zeros unless built with AISDI_STATS; see Stats.h.
+        using Recorder::getStats;
+        using Recorder::resetStats;
+
         bool isEmpty() const
         {
             if (current_size == 0)
@@ -114,80 +834,139 @@ namespace aisdi
             return this->capacity;
         }
 
+        // The elements are contiguous: data()[0, getSize()).
+        pointer data()
+        {
+            return buffer;
+        }
+
+        const_pointer data() const
+        {
+            return buffer;
+        }
+
         void add_memory()
         {
-            capacity *= 2;
-            pointer new_buffer = new value_type [capacity];
-            for (size_type i = 0; i < current_size; i++)
-                new_buffer[i] = buffer [i];
-            delete[] buffer;
-            buffer = new_buffer;
+            reallocate(GrowthPolicy::grow(capacity, capacity + 1));
+        }
+
+        // Makes room for at least count elements from the current front, so
+        // appending up to count elements does not reallocate.
+        void reserve(size_type count)
+        {
+            if (count > capacity - front)
+                reallocate(count);
+        }
+
+        // Appends count elements that fill(first, count) writes in place,
+        // without constructing them first; fill has to write all of them or
+        // throw, in which case nothing is appended. Only for trivially
+        // copyable types, whose bytes are all there is to them.
+        template <typename Fill>
+        void appendOverwrite(size_type count, Fill fill)
+        {
+            static_assert(std::is_trivially_copyable<value_type>::value, "appendOverwrite needs a trivially copyable type!");
+            if (count > backRoom())
+                reallocate(GrowthPolicy::grow(capacity - front, current_size + count));
+            fill(buffer + current_size, count);
+            current_size += count;
+        }
+
+        // Gives back every unused slot, including front room left by pops.
+        // Elements that fit move back into the inline storage.
+        void shrinkToFit()
+        {
+            if (capacity > current_size && !usesInlineStorage())
+                reallocate(current_size);
         }
 
         void append(const Type& item)
         {
-            if (current_size+1 == capacity)
-                add_memory();
-            buffer[current_size] = item;
-            current_size++;
+            emplaceAt(current_size, item);
+        }
+
+        void append(Type&& item)
+        {
+            emplaceAt(current_size, std::move(item));
+        }
+
+        template <typename InputIt, typename = RequireInputIterator<InputIt>>
+        void append(InputIt first, InputIt last)
+        {
+            insertRange(current_size, first, last, typename std::iterator_traits<InputIt>::iterator_category());
         }
 
         void prepend(const Type& item)
         {
-            if (current_size+1 == capacity)
-                add_memory();
-            pointer new_buffer;
-            new_buffer = new value_type[current_size+1];
-            new_buffer[0] = item;
-            for (size_type i = 0; i < current_size; i++)
-                new_buffer[i+1] = buffer[i];
-            delete[] buffer;
-            buffer = new_buffer;
-            current_size++;
+            emplaceAt(0, item);
+        }
+
+        void prepend(Type&& item)
+        {
+            emplaceAt(0, std::move(item));
         }
 
         void insert(const const_iterator& insertPosition, const Type& item)
         {
-            if (insertPosition == end())
-                append(item);
-            else if (insertPosition == begin())
-                prepend(item);
-            else
-            {
-                size_type to_alloc = 0;
-                if (current_size+1 == capacity)
-                {
-                    add_memory();
-                    to_alloc = capacity;
-                }
-                pointer new_buffer = new value_type [capacity+to_alloc];
-                size_type index = 0;
+            emplaceAt(positionOf(insertPosition), item);
+        }
 
-                for (auto i = begin(); i != insertPosition; i++)
-                {
-                    new_buffer[index] = buffer[index];
-                    index++;
-                }
-                new_buffer[index] = item;
+        void insert(const const_iterator& insertPosition, Type&& item)
+        {
+            emplaceAt(positionOf(insertPosition), std::move(item));
+        }
 
-                for (auto i = iterator (insertPosition); i != end(); i++)
-                {
-                    new_buffer [index+1] = buffer[index];
-                    index++;
-                }
-                delete[] buffer;
-                buffer = new_buffer;
-                current_size++;
-            }
+        template <typename InputIt, typename = RequireInputIterator<InputIt>>
+        void insert(const const_iterator& insertPosition, InputIt first, InputIt last)
+        {
+            insertRange(positionOf(insertPosition), first, last, typename std::iterator_traits<InputIt>::iterator_category());
+        }
+
+        template <typename InputIt, typename = RequireInputIterator<InputIt>>
+        void assign(InputIt first, InputIt last)
+        {
+            destroy(buffer, buffer + current_size);
+            buffer -= front;
+            front = 0;
+            current_size = 0;
+            append(first, last);
+        }
+
+        void assign(std::initializer_list<Type> l)
+        {
+            assign(l.begin(), l.end());
+        }
+
+        template <typename... Args>
+        reference emplaceBack(Args&&... args)
+        {
+            emplaceAt(current_size, std::forward<Args>(args)...);
+            return buffer[current_size - 1];
+        }
+
+        template <typename... Args>
+        reference emplaceFront(Args&&... args)
+        {
+            emplaceAt(0, std::forward<Args>(args)...);
+            return buffer[0];
+        }
+
+        template <typename... Args>
+        iterator emplace(const const_iterator& position, Args&&... args)
+        {
+            size_type index = positionOf(position);
+            emplaceAt(index, std::forward<Args>(args)...);
+            return iterator(ConstIterator(buffer + index, this));
         }
 
         Type popFirst()
         {
             if (current_size == 0)
                 throw std::logic_error("You are trying to pop an empty vector!");
-            auto Ret = *(begin());
-            for (size_type i = 0; i < current_size; i++)
-                buffer[i] = buffer[i+1];
+            auto Ret = std::move(buffer[0]);
+            destroy(buffer);
+            buffer++;
+            front++;
             current_size--;
             return Ret;
         }
@@ -196,8 +975,9 @@ namespace aisdi
         {
             if (current_size == 0)
                 throw std::logic_error("You are trying to pop an empty vector!");
-            auto Ret = *(end()-1);
+            auto Ret = std::move(buffer[current_size - 1]);
             current_size--;
+            destroy(buffer + current_size);
             return Ret;
         }
 
@@ -205,34 +985,114 @@ namespace aisdi
         {
             if (possition == end())
                 throw std::out_of_range("Erasing vector end!");
-            else if (possition == begin ())
-            {
-                popFirst();
-            }
-            else if (possition == --end())
+            erase(possition, possition + 1);
+        }
+
+        void erase(const const_iterator& firstIncluded, const const_iterator& lastExcluded)
+        {
+            if (firstIncluded == end())
+                throw std::out_of_range("Erasing vector end!");
+            if (firstIncluded == lastExcluded)
+                return;
+            size_type first = positionOf(firstIncluded);
+            size_type last = positionOf(lastExcluded);
+            size_type dif = last - first;
+            // Close the gap from whichever side has fewer elements to move.
+            if (first < current_size - last)
             {
-                popLast();
+                shiftElements(buffer, buffer + first, buffer + dif);
+                destroy(buffer, buffer + dif);
+                buffer += dif;
+                front += dif;
             }
             else
             {
-                for (iterator it = possition; it!=end(); it++)
-                    buffer[(it.actual_element)] = buffer[(it.actual_element+1)];
-                current_size--;
+                shiftElements(buffer + last, buffer + current_size, buffer + first);
+                destroy(buffer + current_size - dif, buffer + current_size);
+            }
+            current_size-=dif;
+        }
+
+        // Removes every element pred holds for in one pass: each kept element
+        // is moved at most once, into the first free slot, and the tail left
+        // over is destroyed. Returns how many elements were removed.
+        template <typename Predicate>
+        size_type eraseIf(Predicate pred)
+        {
+            pointer last = buffer + current_size;
+            pointer kept = std::find_if(buffer, last, pred);
+            if (kept == last)
+                return 0;
+            size_type moved = 0;
+            for (pointer current = kept + 1; current != last; ++current)
+                if (!pred(*current))
+                {
+                    *kept++ = std::move(*current);
+                    moved++;
+                }
+            this->recordMoves(moved);
+            size_type removed = static_cast<size_type>(last - kept);
+            destroy(kept, last);
+            current_size -= removed;
+            return removed;
+        }
 
+        // value may be an element of this vector, which the pass would
+        // overwrite, so such a value is compared through a copy.
+        size_type remove(const Type& value)
+        {
+            std::less<const Type*> before;
+            if (!before(&value, buffer) && before(&value, buffer + current_size))
+            {
+                const Type copy(value);
+                return remove(copy);
             }
+            return eraseIf([&value](const Type& item) { return item == value; });
         }
 
-        void erase(const const_iterator& firstIncluded, const const_iterator& lastExcluded)
+        // Keeps the first of every run of elements same holds for, compared
+        // with the last element kept, as std::unique does.
+        template <typename BinaryPredicate>
+        size_type unique(BinaryPredicate same)
         {
-            if (firstIncluded == end())
-                throw std::out_of_range("Erasing vector end!");
-            if (firstIncluded == lastExcluded)
-                return;
-            size_type dif = lastExcluded.actual_element - firstIncluded.actual_element;
-            for (iterator it = lastExcluded; it != end(); it++)
-                buffer[(it.actual_element - dif)] = buffer [it.actual_element];
+            if (current_size < 2)
+                return 0;
+            pointer last = buffer + current_size;
+            pointer kept = std::adjacent_find(buffer, last, same);
+            if (kept == last)
+                return 0;
+            size_type moved = 0;
+            for (pointer current = kept + 2; current != last; ++current)
+                if (!same(*kept, *current))
+                {
+                    *++kept = std::move(*current);
+                    moved++;
+                }
+            this->recordMoves(moved);
+            ++kept;
+            size_type removed = static_cast<size_type>(last - kept);
+            destroy(kept, last);
+            current_size -= removed;
+            return removed;
+        }
 
-            current_size-=dif;
+        size_type unique()
+        {
+            return unique([](const Type& first, const Type& second) { return first == second; });
+        }
+
+        // Introsort through comp (std::sort): O(n log n) at worst, not stable.
+        template <typename Compare>
+        void sort(Compare comp)
+        {
+            std::sort(buffer, buffer + current_size, comp);
+        }
+
+        // Ascending. Integers past RadixThreshold are radix sorted in
+        // O(n) through a scratch buffer as large as the vector.
+        void sort()
+        {
+            sortAscending(RadixSortable());
         }
 
         iterator begin()
@@ -247,12 +1107,12 @@ namespace aisdi
 
         const_iterator cbegin() const
         {
-            return ConstIterator(0, this);
+            return ConstIterator(buffer, this);
         }
 
         const_iterator cend() const
         {
-            return ConstIterator(current_size, this);
+            return ConstIterator(buffer + current_size, this);
         }
 
         const_iterator begin() const
@@ -267,12 +1127,15 @@ namespace aisdi
     };
 
 
-    template <typename Type>
-    class Vector<Type>::ConstIterator
+    template <typename Type, typename GrowthPolicy, std::size_t InlineCapacity, typename Allocator>
+    class Vector<Type, GrowthPolicy, InlineCapacity, Allocator>::ConstIterator
     {
     public:
         friend class Vector;
-        using iterator_category = std::bidirectional_iterator_tag;
+        using iterator_category = std::random_access_iterator_tag;
+#if __cplusplus >= 202002L
+        using iterator_concept = std::contiguous_iterator_tag;
+#endif
         using value_type = typename Vector::value_type;
         using difference_type = typename Vector::difference_type;
         using pointer = typename Vector::const_pointer;
@@ -281,32 +1144,60 @@ namespace aisdi
 
     private:
 
-        size_type actual_element;
-        Vector<Type> const * buffer_pointer;
+        pointer element;
+#if AISDI_CHECKED_ITERATORS
+        Vector const * buffer_pointer;
+
+        difference_type position() const
+        {
+            return element - buffer_pointer->buffer;
+        }
+
+        void checkRange(difference_type d) const
+        {
+            if (position() + d < 0 || position() + d > static_cast<difference_type>(buffer_pointer->current_size))
+                throw std::out_of_range("Moving iterator outside of vector!");
+        }
+#endif
 
     public:
 
-        explicit ConstIterator(size_type actual_element_, Vector<Type> const * buffer_pointer_)
+        explicit ConstIterator(pointer element_ = nullptr, Vector const * buffer_pointer_ = nullptr)
         {
-            actual_element = actual_element_;
+            element = element_;
+#if AISDI_CHECKED_ITERATORS
             buffer_pointer = buffer_pointer_;
+#else
+            (void)buffer_pointer_;
+#endif
         }
 
         reference operator*() const
         {
-            if (actual_element == buffer_pointer->current_size)
-            {
+#if AISDI_CHECKED_ITERATORS
+            if (position() == static_cast<difference_type>(buffer_pointer->current_size))
                 throw std::out_of_range("Dereferencing vector end!");
-            }
-            return buffer_pointer->buffer[actual_element];
+#endif
+            return *element;
+        }
+
+        pointer operator->() const
+        {
+            return &operator*();
+        }
+
+        reference operator[](difference_type d) const
+        {
+            return *(*this + d);
         }
 
         ConstIterator& operator++()
         {
-            if (actual_element == buffer_pointer->current_size)
+#if AISDI_CHECKED_ITERATORS
+            if (position() == static_cast<difference_type>(buffer_pointer->current_size))
                 throw std::out_of_range("Incrementing last element!");
-            else
-                actual_element++;
+#endif
+            ++element;
             return *this;
         }
 
@@ -319,10 +1210,11 @@ namespace aisdi
 
         ConstIterator& operator--()
         {
-            if (actual_element == 0)
+#if AISDI_CHECKED_ITERATORS
+            if (position() == 0)
                 throw std::out_of_range("Decrementing first element!");
-            else
-                actual_element--;
+#endif
+            --element;
             return *this;
         }
 
@@ -333,49 +1225,83 @@ namespace aisdi
             return Ret;
         }
 
+        ConstIterator& operator+=(difference_type d)
+        {
+#if AISDI_CHECKED_ITERATORS
+            checkRange(d);
+#endif
+            element += d;
+            return *this;
+        }
+
+        ConstIterator& operator-=(difference_type d)
+        {
+            return operator+=(-d);
+        }
+
         ConstIterator operator+(difference_type d) const
         {
-            if (d+actual_element > buffer_pointer->current_size)
-                throw std::out_of_range("NOPE");
             auto Ret = *this;
-            while (d--)
-                Ret++;
+            Ret += d;
             return Ret;
         }
 
         ConstIterator operator-(difference_type d) const
         {
-            if (d-actual_element < 0)
-                throw std::out_of_range("NOPEx2");
             auto Ret = *this;
-            while (d--)
-                Ret--;
+            Ret -= d;
             return Ret;
         }
 
+        friend ConstIterator operator+(difference_type d, const ConstIterator& it)
+        {
+            return it + d;
+        }
+
+        difference_type operator-(const ConstIterator& other) const
+        {
+            return element - other.element;
+        }
+
         bool operator==(const ConstIterator& other) const
         {
-            if (actual_element == other.actual_element)
-                return true;
-            return false;
+            return element == other.element;
         }
 
         bool operator!=(const ConstIterator& other) const
         {
-            if (actual_element != other.actual_element)
-                return true;
-            return false;
+            return element != other.element;
+        }
+
+        bool operator<(const ConstIterator& other) const
+        {
+            return element < other.element;
+        }
+
+        bool operator>(const ConstIterator& other) const
+        {
+            return element > other.element;
+        }
+
+        bool operator<=(const ConstIterator& other) const
+        {
+            return element <= other.element;
+        }
+
+        bool operator>=(const ConstIterator& other) const
+        {
+            return element >= other.element;
         }
     };
 
-    template <typename Type>
-    class Vector<Type>::Iterator : public Vector<Type>::ConstIterator
+    template <typename Type, typename GrowthPolicy, std::size_t InlineCapacity, typename Allocator>
+    class Vector<Type, GrowthPolicy, InlineCapacity, Allocator>::Iterator : public Vector<Type, GrowthPolicy, InlineCapacity, Allocator>::ConstIterator
     {
     public:
         using pointer = typename Vector::pointer;
         using reference = typename Vector::reference;
 
-        explicit Iterator(/*size_type actual_element_, Vector<Type> const * buffer_pointer_*/)
+        explicit Iterator()
         {}
 
         Iterator(const ConstIterator& other)
@@ -408,11 +1334,30 @@ namespace aisdi
             return result;
         }
 
+        Iterator& operator+=(difference_type d)
+        {
+            ConstIterator::operator+=(d);
+            return *this;
+        }
+
+        Iterator& operator-=(difference_type d)
+        {
+            ConstIterator::operator-=(d);
+            return *this;
+        }
+
         Iterator operator+(difference_type d) const
         {
             return ConstIterator::operator+(d);
         }
 
+        friend Iterator operator+(difference_type d, const Iterator& it)
+        {
+            return it + d;
+        }
+
+        using ConstIterator::operator-;
+
         Iterator operator-(difference_type d) const
         {
             return ConstIterator::operator-(d);
@@ -423,8 +1368,43 @@ namespace aisdi
             // ugly cast, yet reduces code duplication.
             return const_cast<reference>(ConstIterator::operator*());
         }
+
+        pointer operator->() const
+        {
+            return &operator*();
+        }
+
+        reference operator[](difference_type d) const
+        {
+            return *(*this + d);
+        }
     };
 
+    // A Vector that keeps up to N elements inside the object, so short
+    // sequences are built and destroyed without touching the heap. Moving
+    // a SmallVector whose elements are inline moves them one by one.
+    template <typename Type, std::size_t N, typename GrowthPolicy = DoublingGrowth>
+    using SmallVector = Vector<Type, GrowthPolicy, N>;
+
+    template <typename Type, typename GrowthPolicy, std::size_t InlineCapacity, typename Allocator>
+    void swap(Vector<Type, GrowthPolicy, InlineCapacity, Allocator>& first, Vector<Type, GrowthPolicy, InlineCapacity, Allocator>& second)
+    {
+        first.swap(second);
+    }
+
+#if AISDI_PMR
+    // Vectors whose buffers, and the allocations of elements that take an
+    // allocator, come from a std::pmr::memory_resource.
+    namespace pmr
+    {
+        template <typename Type, typename GrowthPolicy = DoublingGrowth>
+        using Vector = aisdi::Vector<Type, GrowthPolicy, 0, std::pmr::polymorphic_allocator<Type>>;
+
+        template <typename Type, std::size_t N, typename GrowthPolicy = DoublingGrowth>
+        using SmallVector = aisdi::Vector<Type, GrowthPolicy, N, std::pmr::polymorphic_allocator<Type>>;
+    }
+#endif
+
 }
 
 #endif // AISDI_LINEAR_VECTOR_H
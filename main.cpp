@@ -1,10 +1,79 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
+#include <cstdio>
 #include <cstdlib>
-#include <string>
-#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Benchmark.h"
 #include "Vector.h"
 #include "LinkedList.h"
+#include "UnrolledList.h"
+#include "IndexedList.h"
+#include "ConcurrentQueue.h"
+#include "Parallel.h"
+#include "SimdKernels.h"
+#include "Serialization.h"
+#include "SegmentedVector.h"
+#if AISDI_MAPPED_VECTOR
+#include "MappedVector.h"
+#endif
+#if AISDI_POSIX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Counts every heap allocation and release of the program, so benchmarks
+// can report allocations per operation and tests can check what is still
+// held. Kept out of line so GCC does not pair the inlined malloc/free with
+// the new/delete expressions of callers.
+std::atomic<std::size_t> allocationCount(0);
+std::atomic<std::size_t> releaseCount(0);
+
+#if defined(__GNUC__) || defined(__clang__)
+#define AISDI_NOINLINE __attribute__((noinline))
+#else
+#define AISDI_NOINLINE
+#endif
+
+AISDI_NOINLINE void* operator new(std::size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size == 0 ? 1 : size))
+        return memory;
+    throw std::bad_alloc();
+}
+
+AISDI_NOINLINE void operator delete(void* memory) noexcept
+{
+    if (memory != nullptr)
+        releaseCount.fetch_add(1, std::memory_order_relaxed);
+    std::free(memory);
+}
+
+#ifdef __cpp_sized_deallocation
+AISDI_NOINLINE void operator delete(void* memory, std::size_t) noexcept
+{
+    if (memory != nullptr)
+        releaseCount.fetch_add(1, std::memory_order_relaxed);
+    std::free(memory);
+}
+#endif
 
 namespace
 {
@@ -12,24 +81,47 @@ namespace
 template <typename T>
 using LinearCollection = aisdi::LinkedList<T>;
 
-void perfomTest()
+// Longer than any small-string buffer, so every copy is a heap allocation.
+const std::size_t payloadLength = 64;
+const int payloadCount = 100;
+
+// Copies every payload in and reads it back out by copy, as the
+// const Type& only API forced callers to.
+template <typename Collection = LinearCollection<std::string>>
+std::size_t perfomTest()
 {
-  LinearCollection<std::string> collection;
-  collection.append("TODO");
+  const std::string payload(payloadLength, 'x');
+  std::size_t total = 0;
+  Collection collection;
+  for (int i = 0; i < payloadCount; ++i)
+    collection.append(payload);
+  while (!collection.isEmpty())
+  {
+    std::string last = *(collection.end() - 1);
+    collection.popLast();
+    total += last.size();
+  }
+  return total;
 }
 
-} // namespace
-
-template<typename Func>
-long long measureTime(Func f) {
-    auto start = std::chrono::high_resolution_clock::now();
-    f();
-    auto finish = std::chrono::high_resolution_clock::now();
-    auto dur = finish - start;
-    std::cout<<std::chrono::duration_cast<std::chrono::milliseconds>(dur).count();
-    return std::chrono::duration_cast<std::chrono::milliseconds>(dur).count();
+// Builds every payload in place and moves it back out.
+template <typename Collection = LinearCollection<std::string>>
+std::size_t perfomMoveTest()
+{
+  std::size_t total = 0;
+  Collection collection;
+  for (int i = 0; i < payloadCount; ++i)
+    collection.emplaceBack(payloadLength, 'x');
+  while (!collection.isEmpty())
+  {
+    std::string last = collection.popLast();
+    total += last.size();
+  }
+  return total;
 }
 
+} // namespace
+
 void fillVector(aisdi::Vector<int> &vector, int elements)
 {
     for (int i = 0; i < elements; ++i) {
@@ -44,35 +136,1283 @@ void fillLinkedList(aisdi::LinkedList<int> &linkedList, int elements)
     }
 }
 
-void performAppend (int elements, int new_elements)
+// Same bytes as int, but its user-provided copy operations force Vector
+// onto the element-by-element path.
+struct CopyableInt
+{
+    int value;
+
+    CopyableInt(int value_ = 0) : value(value_) {}
+    CopyableInt(const CopyableInt& other) : value(other.value) {}
+    CopyableInt& operator=(const CopyableInt& other) { value = other.value; return *this; }
+};
+
+// Plain data large enough that every element move is a real copy.
+struct LargePod
+{
+    char bytes[128];
+};
+
+template <typename T> struct TypeName;
+template <> struct TypeName<int> { static const char* get() { return "int"; } };
+template <> struct TypeName<float> { static const char* get() { return "float"; } };
+template <> struct TypeName<double> { static const char* get() { return "double"; } };
+template <> struct TypeName<CopyableInt> { static const char* get() { return "CopyableInt"; } };
+template <> struct TypeName<std::string> { static const char* get() { return "string"; } };
+template <> struct TypeName<LargePod> { static const char* get() { return "LargePod128"; } };
+
+template <typename T> T makeValue(std::size_t i);
+
+template <> int makeValue<int>(std::size_t i)
+{
+    return static_cast<int>(i);
+}
+
+template <> float makeValue<float>(std::size_t i)
+{
+    return static_cast<float>(i % 1000);
+}
+
+template <> double makeValue<double>(std::size_t i)
+{
+    return static_cast<double>(i);
+}
+
+template <> CopyableInt makeValue<CopyableInt>(std::size_t i)
+{
+    return CopyableInt(static_cast<int>(i));
+}
+
+template <> std::string makeValue<std::string>(std::size_t i)
+{
+    return std::string(payloadLength, static_cast<char>('a' + i % 26));
+}
+
+template <> LargePod makeValue<LargePod>(std::size_t i)
+{
+    LargePod pod;
+    std::memset(pod.bytes, static_cast<int>(i), sizeof(pod.bytes));
+    return pod;
+}
+
+std::size_t checksum(int value) { return static_cast<std::size_t>(value); }
+std::size_t checksum(const CopyableInt& value) { return static_cast<std::size_t>(value.value); }
+std::size_t checksum(const std::string& value) { return value.size(); }
+std::size_t checksum(const LargePod& value) { return static_cast<unsigned char>(value.bytes[0]); }
+
+template <typename Collection>
+Collection filledCollection(std::size_t elements)
+{
+    Collection collection;
+    for (std::size_t i = 0; i < elements; ++i)
+        collection.append(makeValue<typename Collection::value_type>(i));
+    return collection;
+}
+
+// Positions are resolved in setup, so walking a LinkedList to them is not timed.
+template <typename Collection>
+struct PositionFixture
+{
+    Collection collection;
+    typename Collection::iterator first;
+    typename Collection::iterator last;
+
+    PositionFixture(std::size_t elements, std::size_t firstIndex, std::size_t lastIndex)
+        : collection(filledCollection<Collection>(elements)),
+          first(collection.begin() + firstIndex),
+          last(collection.begin() + lastIndex)
+    {}
+};
+
+template <typename Collection>
+struct CopyFixture
+{
+    Collection original;
+    Collection copy;
+
+    explicit CopyFixture(std::size_t elements)
+        : original(filledCollection<Collection>(elements))
+    {}
+};
+
+// Vector iterators are invalidated by every insert, so the middle is
+// recomputed (in O(1)); a LinkedList keeps inserting before the same node.
+template <typename T, typename GrowthPolicy, std::size_t InlineCapacity, typename Allocator>
+void insertMiddle(aisdi::Vector<T, GrowthPolicy, InlineCapacity, Allocator>& vector_,
+                  typename aisdi::Vector<T, GrowthPolicy, InlineCapacity, Allocator>::iterator&, const T& value)
+{
+    vector_.insert(vector_.begin() + vector_.getSize() / 2, value);
+}
+
+template <typename T, template <typename, typename> class NodeStorage, typename Allocator>
+void insertMiddle(aisdi::LinkedList<T, NodeStorage, Allocator>& list_, typename aisdi::LinkedList<T, NodeStorage, Allocator>::iterator& middle, const T& value)
+{
+    list_.insert(middle, value);
+}
+
+template <typename T>
+void insertMiddle(aisdi::IndexedList<T>& list_, typename aisdi::IndexedList<T>::iterator& middle, const T& value)
+{
+    list_.insert(middle, value);
+}
+
+// An unrolled list may split the node under the iterator, so it follows
+// the iterator returned for the new element.
+template <typename T, std::size_t NodeCapacity>
+void insertMiddle(aisdi::UnrolledList<T, NodeCapacity>& list_, typename aisdi::UnrolledList<T, NodeCapacity>::iterator& middle, const T& value)
+{
+    middle = list_.emplace(middle, value);
+}
+
+// Inline elements are already part of sizeof(vector_).
+template <typename T, typename GrowthPolicy, std::size_t InlineCapacity, typename Allocator>
+double bytesPerElement(const aisdi::Vector<T, GrowthPolicy, InlineCapacity, Allocator>& vector_)
+{
+    std::size_t heapCapacity = vector_.getCapacity() > InlineCapacity ? vector_.getCapacity() : 0;
+    return static_cast<double>(sizeof(vector_) + heapCapacity * sizeof(T)) / vector_.getSize();
+}
+
+// Same layout as LinkedList's private Node; pool chunk slack is not counted.
+template <typename T>
+struct ListNodeLayout
+{
+    void* Next;
+    void* Prev;
+    T Value;
+};
+
+template <typename T, template <typename, typename> class NodeStorage, typename Allocator>
+double bytesPerElement(const aisdi::LinkedList<T, NodeStorage, Allocator>& list_)
+{
+    return static_cast<double>(sizeof(list_) + (list_.getSize() + 1) * sizeof(ListNodeLayout<T>)) / list_.getSize();
+}
+
+// NodePool slots also name the chunk list they were carved from.
+template <typename T>
+struct PooledNodeLayout
+{
+    void* Owner;
+    ListNodeLayout<T> Node;
+};
+
+template <typename T, typename Allocator>
+double bytesPerElement(const aisdi::LinkedList<T, aisdi::NodePool, Allocator>& list_)
+{
+    return static_cast<double>(sizeof(list_) + (list_.getSize() + 1) * sizeof(PooledNodeLayout<T>)) / list_.getSize();
+}
+
+template <typename T, std::size_t NodeCapacity>
+double bytesPerElement(const aisdi::UnrolledList<T, NodeCapacity>& list_)
+{
+    return static_cast<double>(list_.getMemoryUsage()) / list_.getSize();
+}
+
+template <typename T>
+double bytesPerElement(const aisdi::IndexedList<T>& list_)
+{
+    return static_cast<double>(list_.getMemoryUsage()) / list_.getSize();
+}
+
+template <typename Collection>
+void registerContainerBenchmarks(aisdi::BenchmarkSuite& suite, const std::string& container, const std::vector<std::size_t>& sizes)
+{
+    typedef typename Collection::value_type Type;
+    const std::string type = TypeName<Type>::get();
+    const std::size_t middleOperations = 16;
+
+    for (std::size_t size : sizes)
+    {
+        // Built up front so only the container's own copy of each value is timed.
+        std::vector<Type> values;
+        values.reserve(size);
+        for (std::size_t i = 0; i < size; ++i)
+            values.push_back(makeValue<Type>(i));
+
+        aisdi::BenchmarkResult* appended = suite.run("append", container, type, size, size,
+                  [] { return Collection(); },
+                  [&values](Collection& collection) {
+                      for (const Type& value : values)
+                          collection.append(value);
+                      aisdi::doNotOptimize(collection);
+                  });
+        if (appended != nullptr)
+            appended->counters.push_back(std::make_pair(std::string("bytes/elem"),
+                                                        bytesPerElement(Collection(values.begin(), values.end()))));
+        suite.run("prepend", container, type, size, size,
+                  [] { return Collection(); },
+                  [&values](Collection& collection) {
+                      for (const Type& value : values)
+                          collection.prepend(value);
+                      aisdi::doNotOptimize(collection);
+                  });
+        suite.run("insert-middle", container, type, size, middleOperations,
+                  [size] { return PositionFixture<Collection>(size, size / 2, size / 2); },
+                  [&values, middleOperations](PositionFixture<Collection>& fixture) {
+                      for (std::size_t i = 0; i < middleOperations; ++i)
+                          insertMiddle(fixture.collection, fixture.first, values[i % values.size()]);
+                  });
+        suite.run("erase-range", container, type, size, size / 2,
+                  [size] { return PositionFixture<Collection>(size, size / 4, size / 4 + size / 2); },
+                  [](PositionFixture<Collection>& fixture) {
+                      fixture.collection.erase(fixture.first, fixture.last);
+                  });
+        suite.run("pop-both-ends", container, type, size, size,
+                  [size] { return filledCollection<Collection>(size); },
+                  [](Collection& collection) {
+                      std::size_t sum = 0;
+                      while (!collection.isEmpty())
+                      {
+                          sum += checksum(collection.popFirst());
+                          if (!collection.isEmpty())
+                              sum += checksum(collection.popLast());
+                      }
+                      aisdi::doNotOptimize(sum);
+                  });
+        suite.run("iterate", container, type, size, size,
+                  [size] { return filledCollection<Collection>(size); },
+                  [](Collection& collection) {
+                      std::size_t sum = 0;
+                      for (auto it = collection.cbegin(); it != collection.cend(); ++it)
+                          sum += checksum(*it);
+                      aisdi::doNotOptimize(sum);
+                  });
+        suite.run("copy", container, type, size, size,
+                  [size] { return CopyFixture<Collection>(size); },
+                  [](CopyFixture<Collection>& fixture) {
+                      fixture.copy = fixture.original;
+                      aisdi::doNotOptimize(fixture.copy);
+                  });
+        suite.run("move", container, type, size, 2,
+                  [size] { return CopyFixture<Collection>(size); },
+                  [](CopyFixture<Collection>& fixture) {
+                      Collection moved(std::move(fixture.original));
+                      fixture.copy = std::move(moved);
+                      aisdi::doNotOptimize(fixture.copy);
+                  });
+    }
+}
+
+template <typename List>
+void churnList(List& list_, std::size_t elements, std::size_t rounds)
+{
+    for (std::size_t r = 0; r < rounds; r++) {
+        for (std::size_t i = 0; i < elements; i++)
+            list_.append(static_cast<int>(i));
+        list_.erase(list_.begin(), list_.end());
+    }
+}
+
+struct ArenaList
+{
+    std::vector<char> memory;
+    aisdi::NodeArena arena;
+    aisdi::LinkedList<int> list;
+
+    explicit ArenaList(std::size_t elements)
+        : memory(elements * 64), arena(memory.data(), memory.size()), list(arena)
+    {}
+};
+
+// Append/erase churn through every node storage policy.
+void registerNodeStorageBenchmarks(aisdi::BenchmarkSuite& suite, const std::vector<std::size_t>& sizes)
+{
+    const std::size_t rounds = 4;
+    for (std::size_t size : sizes)
     {
-        aisdi::Vector<int> vector_;
-        aisdi::LinkedList<int> list_;
+        suite.run("append-erase-churn", "LinkedList<NodeHeap>", "int", size, size * rounds,
+                  [] { return aisdi::LinkedList<int, aisdi::NodeHeap>(); },
+                  [size, rounds](aisdi::LinkedList<int, aisdi::NodeHeap>& list_) { churnList(list_, size, rounds); });
+        suite.run("append-erase-churn", "LinkedList<NodePool>", "int", size, size * rounds,
+                  [] { return aisdi::LinkedList<int>(); },
+                  [size, rounds](aisdi::LinkedList<int>& list_) { churnList(list_, size, rounds); });
+        suite.run("append-erase-churn", "LinkedList<NodeArena>", "int", size, size * rounds,
+                  [size] { return std::unique_ptr<ArenaList>(new ArenaList(size)); },
+                  [size, rounds](std::unique_ptr<ArenaList>& fixture) { churnList(fixture->list, size, rounds); });
+    }
+}
 
-        fillVector(vector_, elements);
-        fillLinkedList(list_, elements);
+// Heap allocations per operation of one untimed call of work.
+template <typename Work>
+void addAllocationCounter(aisdi::BenchmarkResult* result, std::size_t operations, Work work)
+{
+    if (result == nullptr)
+        return;
+    std::size_t before = allocationCount;
+    aisdi::doNotOptimize(work());
+    result->counters.push_back(std::make_pair(std::string("allocs/op"),
+                                              static_cast<double>(allocationCount - before) / operations));
+}
 
-    auto start = std::chrono::high_resolution_clock::now();
-    for (int i = 0; i < new_elements; i++) {
-        vector_.append(i);
+template <typename Collection>
+void registerStringPayloadBenchmarks(aisdi::BenchmarkSuite& suite, const std::string& container, std::size_t repeatCount)
+{
+    aisdi::BenchmarkResult* copied = suite.run("string-copy-in-out", container, "string", payloadCount, repeatCount * payloadCount,
+              [] { return 0; },
+              [repeatCount](int&) {
+                  std::size_t total = 0;
+                  for (std::size_t i = 0; i < repeatCount; ++i)
+                      total += perfomTest<Collection>();
+                  aisdi::doNotOptimize(total);
+              });
+    addAllocationCounter(copied, payloadCount, perfomTest<Collection>);
+    aisdi::BenchmarkResult* moved = suite.run("string-emplace-move-out", container, "string", payloadCount, repeatCount * payloadCount,
+              [] { return 0; },
+              [repeatCount](int&) {
+                  std::size_t total = 0;
+                  for (std::size_t i = 0; i < repeatCount; ++i)
+                      total += perfomMoveTest<Collection>();
+                  aisdi::doNotOptimize(total);
+              });
+    addAllocationCounter(moved, payloadCount, perfomMoveTest<Collection>);
+}
+
+// The perfomTest pattern for the short sequences most vectors hold: build
+// one, fill it, drop it.
+template <typename Collection>
+std::size_t createAppendDestroy(std::size_t length, std::size_t rounds)
+{
+    std::size_t total = 0;
+    for (std::size_t round = 0; round < rounds; ++round)
+    {
+        Collection collection;
+        for (std::size_t i = 0; i < length; ++i)
+            collection.append(static_cast<int>(i));
+        aisdi::doNotOptimize(collection);
+        total += collection.getSize();
     }
-    auto finish = std::chrono::high_resolution_clock::now();
-    std::chrono::duration<double> elapsed = finish - start;
-    std::cout << "> Vector elapsed time: " << elapsed.count() << " s\n";
+    return total;
+}
 
-    start = std::chrono::high_resolution_clock::now();
-    for (int i = 0; i < new_elements; i++) {
-        list_.append(i);
+template <typename Collection>
+void registerShortSequenceBenchmarks(aisdi::BenchmarkSuite& suite, const std::string& container)
+{
+    const std::size_t rounds = 10000;
+    for (std::size_t length : {4, 16, 64})
+    {
+        aisdi::BenchmarkResult* result = suite.run("create-append-destroy", container, "int", length, rounds,
+                  [] { return 0; },
+                  [length, rounds](int&) {
+                      aisdi::doNotOptimize(createAppendDestroy<Collection>(length, rounds));
+                  });
+        addAllocationCounter(result, rounds, [length, rounds] { return createAppendDestroy<Collection>(length, rounds); });
+    }
+}
+
+#if AISDI_PMR
+// The scratch containers of one request, built, read and dropped; resource
+// is the memory_resource they take, if any.
+template <typename VectorType, typename ListType, typename... Resource>
+std::size_t handleRequest(std::size_t length, Resource... resource)
+{
+    VectorType vector_(resource...);
+    ListType list_(resource...);
+    for (std::size_t i = 0; i < length; ++i)
+    {
+        vector_.append(static_cast<int>(i));
+        list_.append(static_cast<int>(i));
+    }
+    aisdi::doNotOptimize(vector_);
+    aisdi::doNotOptimize(list_);
+    return vector_.getSize() + list_.getSize();
+}
+
+// A per-request arena against the default heap for short-lived containers.
+// Each request gets a fresh monotonic_buffer_resource over the same buffer,
+// so nothing is freed one by one and nothing reaches the heap; new_delete
+// shows what the polymorphic allocator costs by itself.
+void registerAllocatorBenchmarks(aisdi::BenchmarkSuite& suite)
+{
+    typedef aisdi::Vector<int> HeapVector;
+    typedef aisdi::LinkedList<int> HeapList;
+    typedef aisdi::pmr::Vector<int> PmrVector;
+    typedef aisdi::pmr::LinkedList<int> PmrList;
+    const std::size_t rounds = 10000;
+    for (std::size_t length : {4, 16, 64, 256})
+    {
+        auto heap = [length, rounds] {
+            std::size_t total = 0;
+            for (std::size_t round = 0; round < rounds; ++round)
+                total += handleRequest<HeapVector, HeapList>(length);
+            return total;
+        };
+        auto newDelete = [length, rounds] {
+            std::size_t total = 0;
+            for (std::size_t round = 0; round < rounds; ++round)
+                total += handleRequest<PmrVector, PmrList>(length, std::pmr::new_delete_resource());
+            return total;
+        };
+        std::shared_ptr<std::vector<char>> buffer = std::make_shared<std::vector<char>>(4096 + length * 64);
+        auto monotonic = [length, rounds, buffer] {
+            std::size_t total = 0;
+            for (std::size_t round = 0; round < rounds; ++round)
+            {
+                std::pmr::monotonic_buffer_resource arena(buffer->data(), buffer->size());
+                total += handleRequest<PmrVector, PmrList>(length, &arena);
+            }
+            return total;
+        };
+        // new_delete_resource allocates with aligned operator new, which
+        // the allocation counter does not see, so it is not counted.
+        struct Variant
+        {
+            const char* container;
+            std::function<std::size_t()> request;
+            bool counted;
+        };
+        const Variant variants[] = {
+            {"Vector+List", heap, true},
+            {"pmr::Vector+List<new>", newDelete, false},
+            {"pmr::Vector+List<mono>", monotonic, true},
+        };
+        for (const Variant& variant : variants)
+        {
+            const std::function<std::size_t()>& request = variant.request;
+            aisdi::BenchmarkResult* result = suite.run("request", variant.container, "int", length, rounds,
+                      [] { return 0; },
+                      [&request](int&) { aisdi::doNotOptimize(request()); });
+            if (variant.counted)
+                addAllocationCounter(result, rounds, request);
+        }
+    }
+}
+#endif
+
+// The floor for iterating a Vector<int>, whatever the iterator policy.
+void registerRawPointerBenchmarks(aisdi::BenchmarkSuite& suite, const std::vector<std::size_t>& sizes)
+{
+    for (std::size_t size : sizes)
+        suite.run("iterate", "raw pointer", "int", size, size,
+                  [size] { return filledCollection<aisdi::Vector<int>>(size); },
+                  [size](aisdi::Vector<int>& vector_) {
+                      long long sum = 0;
+                      const int* data = &*vector_.cbegin();
+                      for (std::size_t i = 0; i < size; i++)
+                          sum += data[i];
+                      aisdi::doNotOptimize(sum);
+                  });
+}
+
+// Middle insert/erase pairs; each shifts the shorter side, about a quarter
+// of the elements, so the result is also reported as bandwidth.
+template <typename Type>
+void registerShiftBenchmarks(aisdi::BenchmarkSuite& suite, const std::vector<std::size_t>& sizes)
+{
+    const std::size_t pairs = 8;
+    for (std::size_t size : sizes)
+    {
+        aisdi::BenchmarkResult* result = suite.run("insert-erase-middle", "Vector", TypeName<Type>::get(), size, 2 * pairs,
+                  [size] { return filledCollection<aisdi::Vector<Type>>(size); },
+                  [size, pairs](aisdi::Vector<Type>& vector_) {
+                      for (std::size_t i = 0; i < pairs; i++) {
+                          vector_.insert(vector_.begin() + size / 4, Type(static_cast<int>(i)));
+                          vector_.erase(vector_.begin() + size / 4);
+                      }
+                  });
+        if (result != nullptr)
+            result->bytesPerOperation = static_cast<double>(size / 4 * sizeof(Type));
+    }
+}
+
+template <typename List>
+struct TwoListFixture
+{
+    List source;
+    List target;
+    typename List::iterator first;
+    typename List::iterator last;
+
+    TwoListFixture(std::size_t elements, std::size_t targetElements, std::size_t firstIndex, std::size_t lastIndex)
+        : source(filledCollection<List>(elements)),
+          target(filledCollection<List>(targetElements)),
+          first(source.begin() + firstIndex),
+          last(source.begin() + lastIndex)
+    {}
+};
+
+template <typename List>
+struct MergeFixture
+{
+    List source;
+    List target;
+
+    explicit MergeFixture(std::size_t elements)
+    {
+        for (std::size_t i = 0; i < elements; i += 2)
+        {
+            target.append(static_cast<int>(i));
+            source.append(static_cast<int>(i + 1));
+        }
+    }
+};
+
+// Relinking operations against moving the same elements by copy.
+void registerSpliceBenchmarks(aisdi::BenchmarkSuite& suite, const std::vector<std::size_t>& sizes)
+{
+    typedef aisdi::LinkedList<int> List;
+    for (std::size_t size : sizes)
+    {
+        suite.run("move-range-splice", "LinkedList", "int", size, size / 2,
+                  [size] { return TwoListFixture<List>(size, size, size / 4, size / 4 + size / 2); },
+                  [](TwoListFixture<List>& fixture) {
+                      fixture.target.splice(fixture.target.end(), fixture.source, fixture.first, fixture.last);
+                  });
+        suite.run("move-range-erase-append", "LinkedList", "int", size, size / 2,
+                  [size] { return TwoListFixture<List>(size, size, size / 4, size / 4 + size / 2); },
+                  [](TwoListFixture<List>& fixture) {
+                      fixture.target.append(fixture.first, fixture.last);
+                      fixture.source.erase(fixture.first, fixture.last);
+                  });
+        suite.run("move-all-splice", "LinkedList", "int", size, size,
+                  [size] { return TwoListFixture<List>(size, size, 0, 0); },
+                  [](TwoListFixture<List>& fixture) {
+                      fixture.target.splice(fixture.target.end(), fixture.source);
+                  });
+        suite.run("move-all-erase-append", "LinkedList", "int", size, size,
+                  [size] { return TwoListFixture<List>(size, size, 0, 0); },
+                  [](TwoListFixture<List>& fixture) {
+                      fixture.target.append(fixture.source.begin(), fixture.source.end());
+                      fixture.source.erase(fixture.source.begin(), fixture.source.end());
+                  });
+        // Every batch brings its own chunk list, which has to be let go
+        // of once the target has released the batch's nodes.
+        suite.run("repeated-small-splice", "LinkedList", "int", size, size,
+                  [] { return List(); },
+                  [size](List& target) {
+                      for (std::size_t i = 0; i < size; i += 4)
+                      {
+                          List batch = {0, 1, 2, 3};
+                          target.splice(target.end(), batch);
+                          if (target.getSize() > 1024)
+                              for (int k = 0; k < 4; k++)
+                                  target.popFirst();
+                      }
+                  });
+        suite.run("split-half-splitAt", "LinkedList", "int", size, size / 2,
+                  [size] { return TwoListFixture<List>(size, 0, size / 2, size / 2); },
+                  [](TwoListFixture<List>& fixture) {
+                      fixture.target = fixture.source.splitAt(fixture.first);
+                  });
+        suite.run("split-half-erase-append", "LinkedList", "int", size, size / 2,
+                  [size] { return TwoListFixture<List>(size, 0, size / 2, size / 2); },
+                  [](TwoListFixture<List>& fixture) {
+                      fixture.target = List(fixture.first, fixture.source.end());
+                      fixture.source.erase(fixture.first, fixture.source.end());
+                  });
+        suite.run("merge-relink", "LinkedList", "int", size, size,
+                  [size] { return MergeFixture<List>(size); },
+                  [](MergeFixture<List>& fixture) {
+                      fixture.target.merge(fixture.source);
+                  });
+        suite.run("merge-copy", "LinkedList", "int", size, size,
+                  [size] { return MergeFixture<List>(size); },
+                  [](MergeFixture<List>& fixture) {
+                      List merged;
+                      auto left = fixture.target.cbegin();
+                      auto right = fixture.source.cbegin();
+                      while (left != fixture.target.cend() && right != fixture.source.cend())
+                          merged.append(*right < *left ? *right++ : *left++);
+                      merged.append(left, fixture.target.cend());
+                      merged.append(right, fixture.source.cend());
+                      fixture.source.erase(fixture.source.begin(), fixture.source.end());
+                      fixture.target = std::move(merged);
+                  });
+    }
+}
+
+// Pseudo-random positions below limit, the same for every container.
+std::vector<std::size_t> randomPositions(std::size_t count, std::size_t limit)
+{
+    std::vector<std::size_t> positions;
+    std::uint64_t state = 88172645463325252ull;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        positions.push_back(static_cast<std::size_t>(state % limit));
+    }
+    return positions;
+}
+
+template <typename Collection>
+const int& valueAt(const Collection& collection, std::size_t index)
+{
+    return *(collection.cbegin() + index);
+}
+
+const int& valueAt(const aisdi::IndexedList<int>& list_, std::size_t index)
+{
+    return list_.at(index);
+}
+
+template <typename Collection>
+void insertAt(Collection& collection, std::size_t index, int value)
+{
+    collection.insert(collection.cbegin() + index, value);
+}
+
+void insertAt(aisdi::IndexedList<int>& list_, std::size_t index, int value)
+{
+    list_.insertAt(index, value);
+}
+
+template <typename Collection>
+void eraseAt(Collection& collection, std::size_t index)
+{
+    collection.erase(collection.cbegin() + index);
+}
+
+void eraseAt(aisdi::IndexedList<int>& list_, std::size_t index)
+{
+    list_.eraseAt(index);
+}
+
+// Lookups, inserts and erases at random indices.
+template <typename Collection>
+void registerPositionalBenchmarks(aisdi::BenchmarkSuite& suite, const std::string& container, const std::vector<std::size_t>& sizes)
+{
+    const std::size_t operations = 64;
+    for (std::size_t size : sizes)
+    {
+        const std::vector<std::size_t> positions = randomPositions(operations, size);
+        suite.run("lookup-at-index", container, "int", size, operations,
+                  [size] { return filledCollection<Collection>(size); },
+                  [&positions](Collection& collection) {
+                      std::size_t sum = 0;
+                      for (std::size_t position : positions)
+                          sum += checksum(valueAt(collection, position));
+                      aisdi::doNotOptimize(sum);
+                  });
+        suite.run("insert-at-index", container, "int", size, operations,
+                  [size] { return filledCollection<Collection>(size); },
+                  [&positions](Collection& collection) {
+                      for (std::size_t i = 0; i < positions.size(); ++i)
+                          insertAt(collection, positions[i], static_cast<int>(i));
+                  });
+        suite.run("erase-at-index", container, "int", size, operations,
+                  [size, operations] { return filledCollection<Collection>(size + operations); },
+                  [&positions](Collection& collection) {
+                      for (std::size_t position : positions)
+                          eraseAt(collection, position);
+                  });
+    }
+}
+
+// LinkedList behind one mutex, the way it was shared between threads.
+template <typename Type>
+class MutexQueue
+{
+private:
+    std::mutex mutex;
+    aisdi::LinkedList<Type> list_;
+
+public:
+    void append(const Type& item)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        list_.append(item);
+    }
+
+    bool tryPopFirst(Type& item)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (list_.isEmpty())
+            return false;
+        item = list_.popFirst();
+        return true;
+    }
+};
+
+// Producers append items values between them while consumers pop until
+// all of them are taken. Returns the sum of everything consumed.
+template <typename Queue>
+std::size_t produceConsume(Queue& queue, std::size_t producers, std::size_t consumers, std::size_t items)
+{
+    std::atomic<std::size_t> consumed(0);
+    std::atomic<std::size_t> sum(0);
+    std::vector<std::thread> threads;
+    for (std::size_t p = 0; p < producers; ++p)
+        threads.emplace_back([&queue, p, producers, items] {
+            for (std::size_t i = p; i < items; i += producers)
+                queue.append(static_cast<int>(i));
+        });
+    for (std::size_t c = 0; c < consumers; ++c)
+        threads.emplace_back([&queue, &consumed, &sum, items] {
+            std::size_t local = 0;
+            int item;
+            while (consumed.load(std::memory_order_relaxed) < items)
+            {
+                if (queue.tryPopFirst(item))
+                {
+                    local += item;
+                    consumed.fetch_add(1, std::memory_order_relaxed);
+                }
+                else
+                    std::this_thread::yield();
+            }
+            sum.fetch_add(local);
+        });
+    for (auto& thread : threads)
+        thread.join();
+    return sum.load();
+}
+
+// Thread start-up is timed too; with this many items it is noise.
+template <typename Queue>
+void registerQueueBenchmarks(aisdi::BenchmarkSuite& suite, const std::string& container)
+{
+    const std::size_t items = 200000;
+    const std::size_t shapes[][2] = {{1, 1}, {2, 2}, {4, 4}, {8, 8}, {4, 1}};
+    for (const auto& shape : shapes)
+    {
+        const std::size_t producers = shape[0];
+        const std::size_t consumers = shape[1];
+        suite.run("queue-" + std::to_string(producers) + "p" + std::to_string(consumers) + "c", container, "int", items, items,
+                  [] { return std::unique_ptr<Queue>(new Queue); },
+                  [producers, consumers, items](std::unique_ptr<Queue>& queue) {
+                      aisdi::doNotOptimize(produceConsume(*queue, producers, consumers, items));
+                  });
+    }
+}
+
+// Thread counts 1, 2, 4, ... up to and including every hardware thread.
+std::vector<std::size_t> threadCounts()
+{
+    std::size_t hardware = std::thread::hardware_concurrency();
+    std::vector<std::size_t> counts;
+    for (std::size_t threads = 1; threads < hardware; threads *= 2)
+        counts.push_back(threads);
+    counts.push_back(hardware == 0 ? 1 : hardware);
+    return counts;
+}
+
+// Scaling of the parallel algorithms over one Vector<int>. The calling
+// thread works too, so a pool of threads - 1 workers uses threads cores.
+void registerParallelBenchmarks(aisdi::BenchmarkSuite& suite, std::size_t size)
+{
+    const char* names[] = {"parallel-for-each", "parallel-transform", "parallel-reduce", "parallel-find"};
+    bool selected = false;
+    for (const char* name : names)
+        selected = selected || suite.selected(name, "Vector", "int");
+    if (!selected || size == 0)
+        return;
+
+    aisdi::Vector<int> data;
+    data.reserve(size);
+    for (std::size_t i = 0; i < size; ++i)
+        data.append(static_cast<int>(i % 1000));
+    aisdi::Vector<int> output(data);
+
+    for (std::size_t threads : threadCounts())
+    {
+        aisdi::ThreadPool pool(threads - 1);
+        const std::string suffix = "/" + std::to_string(threads) + "t";
+        aisdi::BenchmarkResult* result;
+        result = suite.run(names[0] + suffix, "Vector", "int", size, size,
+                  [] { return 0; },
+                  [&pool, &data](int&) {
+                      aisdi::parallelForEach(pool, data.begin(), data.end(), [](int& value) { value ^= 1; });
+                  });
+        if (result != nullptr)
+            result->bytesPerOperation = 2 * sizeof(int);
+        result = suite.run(names[1] + suffix, "Vector", "int", size, size,
+                  [] { return 0; },
+                  [&pool, &data, &output](int&) {
+                      aisdi::parallelTransform(pool, data.cbegin(), data.cend(), output.begin(), [](int value) { return value * 3 + 1; });
+                  });
+        if (result != nullptr)
+            result->bytesPerOperation = 2 * sizeof(int);
+        result = suite.run(names[2] + suffix, "Vector", "int", size, size,
+                  [] { return 0; },
+                  [&pool, &data](int&) {
+                      aisdi::doNotOptimize(aisdi::parallelReduce(pool, data.cbegin(), data.cend(), std::int64_t(0),
+                                                                 [](std::int64_t sum, std::int64_t value) { return sum + value; }));
+                  });
+        if (result != nullptr)
+            result->bytesPerOperation = sizeof(int);
+        // The value is absent, so every element is compared.
+        result = suite.run(names[3] + suffix, "Vector", "int", size, size,
+                  [] { return 0; },
+                  [&pool, &data](int&) {
+                      aisdi::doNotOptimize(aisdi::parallelFind(pool, data.cbegin(), data.cend(), -1));
+                  });
+        if (result != nullptr)
+            result->bytesPerOperation = sizeof(int);
+    }
+}
+
+// The SIMD kernels at every level this CPU runs, next to the same scan
+// through Vector's iterators. The searched value is absent, so every
+// element is read, and GB/s is the read bandwidth.
+template <typename Type>
+void registerSimdBenchmarks(aisdi::BenchmarkSuite& suite, const std::vector<std::size_t>& sizes)
+{
+    typedef aisdi::SimdKernels<Type> Kernels;
+    const std::string type = TypeName<Type>::get();
+    const Type absent = Type(-1);
+    for (std::size_t size : sizes)
+    {
+        if (size == 0)
+            continue;
+        auto setup = [size] { return filledCollection<aisdi::Vector<Type>>(size); };
+        auto report = [](aisdi::BenchmarkResult* result) {
+            if (result != nullptr)
+                result->bytesPerOperation = sizeof(Type);
+        };
+        report(suite.run("find/iterator", "Vector", type, size, size, setup,
+                  [absent](aisdi::Vector<Type>& vector_) {
+                      aisdi::doNotOptimize(std::find(vector_.cbegin(), vector_.cend(), absent) == vector_.cend());
+                  }));
+        report(suite.run("count/iterator", "Vector", type, size, size, setup,
+                  [absent](aisdi::Vector<Type>& vector_) {
+                      aisdi::doNotOptimize(std::count(vector_.cbegin(), vector_.cend(), absent));
+                  }));
+        report(suite.run("min/iterator", "Vector", type, size, size, setup,
+                  [](aisdi::Vector<Type>& vector_) {
+                      aisdi::doNotOptimize(*std::min_element(vector_.cbegin(), vector_.cend()));
+                  }));
+        report(suite.run("sum/iterator", "Vector", type, size, size, setup,
+                  [](aisdi::Vector<Type>& vector_) {
+                      aisdi::doNotOptimize(std::accumulate(vector_.cbegin(), vector_.cend(), aisdi::SumType<Type>(0)));
+                  }));
+        for (int level = 0; level <= static_cast<int>(aisdi::detectSimdLevel()); ++level)
+        {
+            const aisdi::SimdLevel simdLevel = static_cast<aisdi::SimdLevel>(level);
+            const std::string suffix = std::string("/") + aisdi::simdLevelName(simdLevel);
+            report(suite.run("find" + suffix, "Vector", type, size, size, setup,
+                      [absent, simdLevel](aisdi::Vector<Type>& vector_) {
+                          aisdi::doNotOptimize(Kernels::find(vector_.data(), vector_.getSize(), absent, simdLevel));
+                      }));
+            report(suite.run("count" + suffix, "Vector", type, size, size, setup,
+                      [absent, simdLevel](aisdi::Vector<Type>& vector_) {
+                          aisdi::doNotOptimize(Kernels::count(vector_.data(), vector_.getSize(), absent, simdLevel));
+                      }));
+            report(suite.run("min" + suffix, "Vector", type, size, size, setup,
+                      [simdLevel](aisdi::Vector<Type>& vector_) {
+                          aisdi::doNotOptimize(Kernels::min(vector_.data(), vector_.getSize(), simdLevel));
+                      }));
+            report(suite.run("sum" + suffix, "Vector", type, size, size, setup,
+                      [simdLevel](aisdi::Vector<Type>& vector_) {
+                          aisdi::doNotOptimize(Kernels::sum(vector_.data(), vector_.getSize(), simdLevel));
+                      }));
+        }
+    }
+}
+
+#if AISDI_POSIX
+// A scratch file in TMPDIR, or /tmp, private to this process.
+std::string temporaryPath(const std::string& name)
+{
+    const char* directory = std::getenv("TMPDIR");
+    return std::string(directory != nullptr && *directory != '\0' ? directory : "/tmp")
+           + "/aisdi-" + std::to_string(::getpid()) + "-" + name;
+}
+#endif
+
+#if AISDI_MAPPED_VECTOR
+// Startup of a dataset that outlives the process: mapping its file
+// against rebuilding the Vector with fillVector. The -scan variants also
+// read every element once, which is when the mapped pages are faulted in.
+void registerMappedStartupBenchmarks(aisdi::BenchmarkSuite& suite, const std::vector<std::size_t>& sizes)
+{
+    for (std::size_t size : sizes)
+    {
+        suite.run("startup", "Vector", "int", size, 1,
+                  [] { return 0; },
+                  [size](int&) {
+                      aisdi::Vector<int> vector_;
+                      fillVector(vector_, static_cast<int>(size));
+                      aisdi::doNotOptimize(vector_.data());
+                  });
+        suite.run("startup-scan", "Vector", "int", size, 1,
+                  [] { return 0; },
+                  [size](int&) {
+                      aisdi::Vector<int> vector_;
+                      fillVector(vector_, static_cast<int>(size));
+                      aisdi::doNotOptimize(std::accumulate(vector_.cbegin(), vector_.cend(), 0LL));
+                  });
+
+        if (!suite.selected("startup", "MappedVector", "int") && !suite.selected("startup-scan", "MappedVector", "int"))
+            continue;
+        const std::string path = temporaryPath("startup.bin");
+        {
+            aisdi::MappedVector<int> file(path);
+            for (std::size_t i = 0; i < size; ++i)
+                file.append(static_cast<int>(i));
+            file.flush();
+        }
+        suite.run("startup", "MappedVector", "int", size, 1,
+                  [] { return 0; },
+                  [&path](int&) {
+                      aisdi::MappedVector<int> vector_(path, aisdi::MapMode::ReadOnly);
+                      aisdi::doNotOptimize(vector_.data());
+                  });
+        suite.run("startup-scan", "MappedVector", "int", size, 1,
+                  [] { return 0; },
+                  [&path](int&) {
+                      aisdi::MappedVector<int> vector_(path, aisdi::MapMode::ReadOnly);
+                      aisdi::doNotOptimize(std::accumulate(vector_.cbegin(), vector_.cend(), 0LL));
+                  });
+        std::remove(path.c_str());
+    }
+}
+#endif
+
+template <typename Collection>
+struct SerializationFixture
+{
+    Collection collection;
+    std::stringstream stream;
+
+    explicit SerializationFixture(std::size_t elements)
+        : collection(filledCollection<Collection>(elements))
+    {}
+};
+
+// save/load against writing and appending element by element, in memory
+// so only the serialization is measured; the -fd variants go through a
+// file in the page cache. GB/s counts the element bytes.
+template <typename Collection>
+void registerSerializationBenchmarks(aisdi::BenchmarkSuite& suite, const std::string& container, const std::vector<std::size_t>& sizes)
+{
+    typedef SerializationFixture<Collection> Fixture;
+    for (std::size_t size : sizes)
+    {
+        auto empty = [size] { return Fixture(size); };
+        auto raw = [size] {
+            Fixture fixture(size);
+            for (const int& item : fixture.collection)
+                fixture.stream.write(reinterpret_cast<const char*>(&item), sizeof(item));
+            return fixture;
+        };
+        auto saved = [size] {
+            Fixture fixture(size);
+            aisdi::save(fixture.collection, fixture.stream);
+            return fixture;
+        };
+        auto report = [](aisdi::BenchmarkResult* result) {
+            if (result != nullptr)
+                result->bytesPerOperation = sizeof(int);
+        };
+        report(suite.run("save-loop", container, "int", size, size, empty,
+                  [](Fixture& fixture) {
+                      for (const int& item : fixture.collection)
+                          fixture.stream.write(reinterpret_cast<const char*>(&item), sizeof(item));
+                  }));
+        report(suite.run("save", container, "int", size, size, empty,
+                  [](Fixture& fixture) {
+                      aisdi::save(fixture.collection, fixture.stream);
+                  }));
+        report(suite.run("load-loop", container, "int", size, size, raw,
+                  [](Fixture& fixture) {
+                      Collection loaded;
+                      int item;
+                      while (fixture.stream.read(reinterpret_cast<char*>(&item), sizeof(item)))
+                          loaded.append(item);
+                      aisdi::doNotOptimize(loaded.getSize());
+                  }));
+        report(suite.run("load", container, "int", size, size, saved,
+                  [](Fixture& fixture) {
+                      Collection loaded;
+                      aisdi::load(loaded, fixture.stream);
+                      aisdi::doNotOptimize(loaded.getSize());
+                  }));
+#if AISDI_POSIX
+        if (!suite.selected("save-fd", container, "int") && !suite.selected("load-fd", container, "int"))
+            continue;
+        const std::string path = temporaryPath("serialization.bin");
+        auto saveFile = [&path](const Collection& collection) {
+            int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            aisdi::save(collection, fd);
+            ::close(fd);
+        };
+        auto savedFile = [size, &saveFile] {
+            Fixture fixture(size);
+            saveFile(fixture.collection);
+            return fixture;
+        };
+        report(suite.run("save-fd", container, "int", size, size, empty,
+                  [&saveFile](Fixture& fixture) {
+                      saveFile(fixture.collection);
+                  }));
+        report(suite.run("load-fd", container, "int", size, size, savedFile,
+                  [&path](Fixture&) {
+                      Collection loaded;
+                      int fd = ::open(path.c_str(), O_RDONLY);
+                      aisdi::load(loaded, fd);
+                      ::close(fd);
+                      aisdi::doNotOptimize(loaded.getSize());
+                  }));
+        std::remove(path.c_str());
+#endif
+    }
+}
+
+// How long each append of one untimed fill took, in ns. The mean of the
+// append benchmark hides the appends that reallocate; these counters show
+// them: percentiles, the slowest one, and how many fell in each decade.
+template <typename Collection>
+void addAppendLatencyCounters(aisdi::BenchmarkResult* result, const std::vector<typename Collection::value_type>& values)
+{
+    if (result == nullptr || values.empty())
+        return;
+    typedef std::chrono::steady_clock Clock;
+    std::vector<double> latencies;
+    latencies.reserve(values.size());
+    Collection collection;
+    for (const auto& value : values)
+    {
+        Clock::time_point start = Clock::now();
+        collection.append(value);
+        latencies.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+    }
+    aisdi::doNotOptimize(collection);
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double fraction) {
+        return latencies[std::min(latencies.size() - 1, static_cast<std::size_t>(fraction * latencies.size()))];
+    };
+    result->counters.push_back(std::make_pair(std::string("p50-ns"), percentile(0.5)));
+    result->counters.push_back(std::make_pair(std::string("p99-ns"), percentile(0.99)));
+    result->counters.push_back(std::make_pair(std::string("p99.9-ns"), percentile(0.999)));
+    result->counters.push_back(std::make_pair(std::string("max-ns"), latencies.back()));
+    const char* const names[] = {"<=100ns", "<=1us", "<=10us", "<=100us", "<=1ms", ">1ms"};
+    double bound = 100;
+    auto first = latencies.begin();
+    for (const char* name : names)
+    {
+        auto last = name[0] == '>' ? latencies.end() : std::upper_bound(first, latencies.end(), bound);
+        result->counters.push_back(std::make_pair(std::string(name), static_cast<double>(last - first)));
+        first = last;
+        bound *= 10;
+    }
+}
+
+template <typename Collection>
+void appendAll(Collection& collection, const std::vector<typename Collection::value_type>& values)
+{
+    for (const auto& value : values)
+        collection.append(value);
+    aisdi::doNotOptimize(collection);
+}
+
+template <typename Collection>
+const typename Collection::value_type& elementAt(const Collection& collection, std::size_t index)
+{
+    return *(collection.cbegin() + index);
+}
+
+template <typename Type, std::size_t FirstBlock, typename Allocator>
+const Type& elementAt(const aisdi::SegmentedVector<Type, FirstBlock, Allocator>& vector_, std::size_t index)
+{
+    return vector_[index];
+}
+
+template <typename Collection>
+void registerSegmentedVariant(aisdi::BenchmarkSuite& suite, const std::string& container,
+                              const std::vector<typename Collection::value_type>& values,
+                              const std::vector<std::size_t>& positions)
+{
+    const std::string type = TypeName<typename Collection::value_type>::get();
+    const std::size_t size = values.size();
+    addAppendLatencyCounters<Collection>(suite.run("append-latency", container, type, size, size,
+              [] { return Collection(); },
+              [&values](Collection& collection) { appendAll(collection, values); }), values);
+    suite.run("lookup-at-index", container, type, size, positions.size(),
+              [&values] { return Collection(values.begin(), values.end()); },
+              [&positions](Collection& collection) {
+                  std::size_t sum = 0;
+                  for (std::size_t position : positions)
+                      sum += checksum(elementAt(collection, position));
+                  aisdi::doNotOptimize(sum);
+              });
+    suite.run("iterate", container, type, size, size,
+              [&values] { return Collection(values.begin(), values.end()); },
+              [](Collection& collection) {
+                  std::size_t sum = 0;
+                  for (auto it = collection.cbegin(); it != collection.cend(); ++it)
+                      sum += checksum(*it);
+                  aisdi::doNotOptimize(sum);
+              });
+}
+
+// Vector against SegmentedVector: appending, with the latency of single
+// appends, then the price of the block lookups when reading.
+template <typename Type>
+void registerSegmentedBenchmarks(aisdi::BenchmarkSuite& suite, const std::vector<std::size_t>& sizes)
+{
+    for (std::size_t size : sizes)
+    {
+        std::vector<Type> values;
+        values.reserve(size);
+        for (std::size_t i = 0; i < size; ++i)
+            values.push_back(makeValue<Type>(i));
+        const std::vector<std::size_t> positions = randomPositions(64, size);
+        registerSegmentedVariant<aisdi::Vector<Type>>(suite, "Vector", values, positions);
+        registerSegmentedVariant<aisdi::SegmentedVector<Type>>(suite, "SegmentedVector", values, positions);
+    }
+}
+
+// Holds for about permille of every thousand ints, spread over the
+// whole collection.
+struct PermilleOf
+{
+    unsigned permille;
+
+    bool operator()(int value) const
+    {
+        return static_cast<unsigned>(value) * 2654435761u % 1000 < permille;
     }
-    finish = std::chrono::high_resolution_clock::now();
-    elapsed = finish - start;
-    std::cout << ">   List elapsed time: " << elapsed.count() << " s\n\n";
+};
+
+// Erasing one matching element at a time, each erase closing its own gap.
+template <typename Predicate>
+std::size_t eraseEach(aisdi::Vector<int>& vector_, Predicate pred)
+{
+    std::size_t removed = 0;
+    for (std::size_t i = 0; i < vector_.getSize();)
+        if (pred(*(vector_.cbegin() + i)))
+        {
+            vector_.erase(vector_.cbegin() + i);
+            removed++;
+        }
+        else
+            i++;
+    return removed;
+}
+
+// eraseIf at removal ratios from 0.1% to 90%. On a Vector it is set
+// against erasing the same elements one by one, where that takes no more
+// than about 10^8 element moves.
+template <typename Collection>
+void registerEraseIfBenchmarks(aisdi::BenchmarkSuite& suite, const std::string& container, const std::vector<std::size_t>& sizes)
+{
+    const bool compareWithErase = std::is_same<Collection, aisdi::Vector<int>>::value;
+    for (std::size_t size : sizes)
+        for (unsigned permille : {1u, 10u, 100u, 500u, 900u})
+        {
+            std::ostringstream ratio;
+            ratio << permille / 10.0 << "%";
+            const PermilleOf pred{permille};
+            suite.run("erase-if-" + ratio.str(), container, "int", size, size,
+                      [size] { return filledCollection<Collection>(size); },
+                      [pred](Collection& collection) {
+                          aisdi::doNotOptimize(collection.eraseIf(pred));
+                      });
+            if (compareWithErase && static_cast<double>(size) * size * permille / 4000 <= 1e8)
+                suite.run("erase-each-" + ratio.str(), container, "int", size, size,
+                          [size] { return filledCollection<aisdi::Vector<int>>(size); },
+                          [pred](aisdi::Vector<int>& vector_) {
+                              aisdi::doNotOptimize(eraseEach(vector_, pred));
+                          });
+        }
+}
+
+// Copying a list out to sort it and back, as sorting one had to be done.
+std::size_t sortByCopy(aisdi::LinkedList<int>& list_)
+{
+    aisdi::Vector<int> values(list_.begin(), list_.end());
+    values.sort(std::less<int>());
+    list_.assign(values.begin(), values.end());
+    return list_.getSize();
+}
+
+// Random, sorted and reversed ints; the random ones are the positions'
+// xorshift sequence, so they repeat.
+std::vector<int> sortInput(std::size_t size, const std::string& order)
+{
+    std::vector<int> values;
+    values.reserve(size);
+    for (std::size_t i = 0; i < size; ++i)
+        values.push_back(static_cast<int>(i));
+    if (order == "random")
+    {
+        std::vector<std::size_t> positions = randomPositions(size, std::numeric_limits<std::uint32_t>::max());
+        for (std::size_t i = 0; i < size; ++i)
+            values[i] = static_cast<int>(static_cast<std::uint32_t>(positions[i]));
     }
+    else if (order == "reverse")
+        std::reverse(values.begin(), values.end());
+    return values;
+}
+
+// sort() on random, sorted and reversed input: radix and introsort on a
+// Vector, the relinking merge sort on a LinkedList against sorting a copy.
+// sortSize (0 skips it) is run on top of sizes.
+void registerSortBenchmarks(aisdi::BenchmarkSuite& suite, std::vector<std::size_t> sizes, std::size_t sortSize)
+{
+    if (sortSize != 0 && std::find(sizes.begin(), sizes.end(), sortSize) == sizes.end())
+        sizes.push_back(sortSize);
+    for (std::size_t size : sizes)
+        for (const char* order : {"random", "sorted", "reverse"})
+        {
+            const std::string name = std::string("sort-") + order;
+            if (!suite.selected(name, "Vector", "int") && !suite.selected(name, "Vector<introsort>", "int")
+                    && !suite.selected(name, "LinkedList", "int") && !suite.selected(name, "LinkedList+copy", "int"))
+                continue;
+            const std::vector<int> values = sortInput(size, order);
+            suite.run(name, "Vector", "int", size, size,
+                      [&values] { return aisdi::Vector<int>(values.begin(), values.end()); },
+                      [](aisdi::Vector<int>& vector_) { vector_.sort(); });
+            suite.run(name, "Vector<introsort>", "int", size, size,
+                      [&values] { return aisdi::Vector<int>(values.begin(), values.end()); },
+                      [](aisdi::Vector<int>& vector_) { vector_.sort(std::less<int>()); });
+            suite.run(name, "LinkedList", "int", size, size,
+                      [&values] { return aisdi::LinkedList<int>(values.begin(), values.end()); },
+                      [](aisdi::LinkedList<int>& list_) { list_.sort(); });
+            suite.run(name, "LinkedList+copy", "int", size, size,
+                      [&values] { return aisdi::LinkedList<int>(values.begin(), values.end()); },
+                      [](aisdi::LinkedList<int>& list_) { aisdi::doNotOptimize(sortByCopy(list_)); });
+        }
+}
+
+// A list whose traversal order is unrelated to where its nodes lie, as
+// after long insert/erase churn: filled in order, then sorted by a hash of
+// the values, which relinks the nodes without moving them.
+aisdi::LinkedList<int> fragmentedList(std::size_t size)
+{
+    aisdi::LinkedList<int> list_ = filledCollection<aisdi::LinkedList<int>>(size);
+    list_.sort([](int first, int second) {
+        return static_cast<std::uint32_t>(first) * 2654435761u < static_cast<std::uint32_t>(second) * 2654435761u;
+    });
+    return list_;
+}
+
+std::size_t scanSum(const aisdi::LinkedList<int>& list_)
+{
+    std::size_t sum = 0;
+    for (auto it = list_.cbegin(); it != list_.cend(); ++it)
+        sum += checksum(*it);
+    return sum;
+}
+
+// Scanning a fragmented list before and after compact(), and compact()
+// itself. Build with -DAISDI_PREFETCH=1 to see what prefetching adds.
+void registerCompactBenchmarks(aisdi::BenchmarkSuite& suite, const std::vector<std::size_t>& sizes)
+{
+    for (std::size_t size : sizes)
+    {
+        suite.run("scan-fragmented", "LinkedList", "int", size, size,
+                  [size] { return fragmentedList(size); },
+                  [](aisdi::LinkedList<int>& list_) { aisdi::doNotOptimize(scanSum(list_)); });
+        suite.run("scan-compacted", "LinkedList", "int", size, size,
+                  [size] {
+                      aisdi::LinkedList<int> list_ = fragmentedList(size);
+                      list_.compact();
+                      return list_;
+                  },
+                  [](aisdi::LinkedList<int>& list_) { aisdi::doNotOptimize(scanSum(list_)); });
+        suite.run("compact", "LinkedList", "int", size, size,
+                  [size] { return fragmentedList(size); },
+                  [](aisdi::LinkedList<int>& list_) { list_.compact(); });
+    }
+}
 
 void test_getCapacity()
 {
     aisdi::Vector<int> vector_;
-    if (vector_.getCapacity() == 8)
+    size_t empty = vector_.getCapacity();
+    vector_.append(1);
+    if (empty == 0 && vector_.getCapacity() == 8)
         std::cout<< "Get capacity works." << std::endl;
     else
         std::cout <<"ERROR getcapacity" << std::endl;
@@ -85,12 +1425,195 @@ void test_add_memory()
     size_t first = vector_.getCapacity();
     fillVector(vector_, 120);
     int second = vector_.getCapacity();
-    if (first == 8 && second == 128)
+    vector_.add_memory();
+    int third = vector_.getCapacity();
+    if (first == 0 && second == 128 && third == 256)
         std::cout <<"Add_memory works."<< std::endl;
     else
         std::cout <<"ERROR add memory" << std::endl;
 }
 
+void test_reserve()
+{
+    aisdi::Vector<int> vector_;
+    vector_.reserve(1000);
+    size_t first = vector_.getCapacity();
+    fillVector(vector_, 1000);
+    size_t second = vector_.getCapacity();
+    vector_.reserve(10);
+    if (first == 1000 && second == 1000 && vector_.getCapacity() == 1000 && vector_.getSize() == 1000)
+        std::cout <<"Reserve works."<< std::endl;
+    else
+        std::cout <<"ERROR reserve" << std::endl;
+}
+
+void test_shrinkToFit()
+{
+    aisdi::Vector<int> vector_;
+    fillVector(vector_, 100);
+    vector_.erase(vector_.begin() + 10, vector_.end());
+    vector_.popFirst();
+    vector_.shrinkToFit();
+    size_t first = vector_.getCapacity();
+    while (!vector_.isEmpty())
+        vector_.popLast();
+    vector_.shrinkToFit();
+    if (first == 9 && vector_.getCapacity() == 0)
+        std::cout <<"ShrinkToFit works."<< std::endl;
+    else
+        std::cout <<"ERROR shrinkToFit" << std::endl;
+}
+
+void test_growthPolicy()
+{
+    aisdi::Vector<int, aisdi::GrowthFactor<3, 2>> vector_;
+    vector_.append(0);
+    size_t first = vector_.getCapacity();
+    for (int i = 1; i < 9; i++)
+        vector_.append(i);
+    size_t second = vector_.getCapacity();
+    aisdi::Vector<int, aisdi::GrowthFactor<3, 2>> range_(vector_.begin(), vector_.end());
+    range_.append(vector_.begin(), vector_.end());
+    if (first == 8 && second == 12 && range_.getCapacity() == 18 && range_.getSize() == 18)
+        std::cout <<"Growth policy works."<< std::endl;
+    else
+        std::cout <<"ERROR growth policy" << std::endl;
+}
+
+void test_smallVector()
+{
+    aisdi::SmallVector<std::string, 4> vector_ = {"a", "b", "c"};
+    std::size_t before = allocationCount;
+    vector_.append("d");
+    aisdi::SmallVector<std::string, 4> moved(std::move(vector_));
+    bool inline_ = allocationCount == before && moved.getCapacity() == 4 && vector_.isEmpty();
+    moved.append("e");
+    aisdi::SmallVector<std::string, 4> copy(moved);
+    copy.popFirst();
+    copy.popLast();
+    copy.shrinkToFit();
+    vector_ = std::move(moved);
+    if (inline_ && vector_.getSize() == 5 && *(vector_.end() - 1) == "e" && moved.isEmpty()
+            && copy.getCapacity() == 4 && *copy.begin() == "b" && copy.getSize() == 3)
+        std::cout <<"SmallVector works."<< std::endl;
+    else
+        std::cout <<"ERROR smallVector" << std::endl;
+}
+
+// Tells allocators apart by id and propagates on copy, move and swap.
+template <typename T>
+struct PropagatingAllocator
+{
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    int id;
+
+    explicit PropagatingAllocator(int id_) : id(id_)
+    {}
+
+    template <typename U>
+    PropagatingAllocator(const PropagatingAllocator<U>& other) : id(other.id)
+    {}
+
+    T* allocate(std::size_t count)
+    {
+        return std::allocator<T>().allocate(count);
+    }
+
+    void deallocate(T* memory, std::size_t count)
+    {
+        std::allocator<T>().deallocate(memory, count);
+    }
+
+    bool operator==(const PropagatingAllocator& other) const
+    {
+        return id == other.id;
+    }
+
+    bool operator!=(const PropagatingAllocator& other) const
+    {
+        return id != other.id;
+    }
+};
+
+void test_allocators()
+{
+    typedef PropagatingAllocator<int> Allocator;
+    aisdi::Vector<int, aisdi::DoublingGrowth, 0, Allocator> first({1, 2, 3}, Allocator(1)), second(Allocator(2));
+    aisdi::LinkedList<int, aisdi::NodePool, Allocator> firstList({1, 2, 3}, Allocator(1)), secondList(Allocator(2));
+    second = first;
+    secondList = firstList;
+    bool works = second.getAllocator().id == 1 && secondList.getAllocator().id == 1 && second.getSize() == 3;
+    aisdi::Vector<int, aisdi::DoublingGrowth, 0, Allocator> third(Allocator(3));
+    aisdi::LinkedList<int, aisdi::NodePool, Allocator> thirdList(Allocator(3));
+    swap(first, third);
+    swap(firstList, thirdList);
+    works = works && first.getAllocator().id == 3 && third.getAllocator().id == 1 && third.getSize() == 3
+            && firstList.getAllocator().id == 3 && thirdList.getAllocator().id == 1 && thirdList.getSize() == 3;
+    first = std::move(third);
+    firstList = std::move(thirdList);
+    works = works && first.getAllocator().id == 1 && firstList.getAllocator().id == 1 && firstList.getSize() == 3;
+#if AISDI_PMR
+    // Everything, the strings included, has to come from the arena: it
+    // has no upstream to fall back on.
+    char buffer[16384];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+    aisdi::pmr::Vector<std::pmr::string> words(&arena);
+    aisdi::pmr::LinkedList<std::pmr::string> wordList(&arena);
+    std::size_t before = allocationCount;
+    for (int i = 0; i < 20; i++)
+    {
+        words.emplaceBack(64, static_cast<char>('a' + i));
+        wordList.emplaceBack(64, static_cast<char>('a' + i));
+    }
+    works = works && allocationCount == before && (*words.begin()).get_allocator().resource() == &arena
+            && (*wordList.begin()).get_allocator().resource() == &arena;
+    aisdi::pmr::Vector<std::pmr::string> copy(words);
+    copy = std::move(words);
+    works = works && copy.getAllocator().resource() == std::pmr::get_default_resource()
+            && (*copy.begin()).get_allocator().resource() == std::pmr::get_default_resource()
+            && words.getAllocator().resource() == &arena && copy.getSize() == 20;
+#endif
+    if (works)
+        std::cout << "Allocators work." << std::endl;
+    else
+        std::cout << "Allocators ERROR" << std::endl;
+}
+
+void test_stats()
+{
+    aisdi::Vector<int> vector_;
+    aisdi::LinkedList<int> list_;
+    for (int i = 0; i < 100; i++)
+    {
+        vector_.append(i);
+        list_.append(i);
+    }
+    aisdi::Vector<int> copy(vector_);
+    aisdi::ContainerStats vectorStats = vector_.getStats();
+    aisdi::ContainerStats listStats = list_.getStats();
+#if AISDI_STATS
+    // Capacities 8, 16, 32, 64 and 128: four reallocations, which move
+    // 8 + 16 + 32 + 64 elements. The list allocates its sentinel too.
+    bool works = vectorStats.allocations == 5 && vectorStats.frees == 4 && vectorStats.reallocations == 4
+                 && vectorStats.elementsMoved == 120 && vectorStats.peakCapacity == 128
+                 && copy.getStats().elementsCopied == 100 && copy.getStats().allocations == 1
+                 && listStats.allocations == 101 && listStats.peakCapacity == 100
+                 && aisdi::globalStats(aisdi::StatsFamily::Vector).snapshot().allocations >= 6;
+#else
+    // Nothing is counted, and the counters take no room in the containers.
+    bool works = vectorStats.allocations == 0 && listStats.allocations == 0 && copy.getStats().elementsCopied == 0
+                 && sizeof(aisdi::Vector<int>) == 3 * sizeof(std::size_t) + sizeof(int*);
+#endif
+    if (works)
+        std::cout << "Stats work." << std::endl;
+    else
+        std::cout << "Stats ERROR" << std::endl;
+}
+
 void test_popFirst_vector()
 {
     aisdi::Vector<int> vector_;
@@ -111,19 +1634,758 @@ void test_popFirst_list()
         std::cout<< "pop list error" << std::endl;
 }
 
+template <typename Collection>
+bool hasContents(const Collection& collection, std::initializer_list<typename Collection::value_type> expected)
+{
+    if (collection.getSize() != expected.size())
+        return false;
+    auto it = collection.cbegin();
+    for (const auto& value : expected)
+        if (*it++ != value)
+            return false;
+    return it == collection.cend();
+}
+
+void test_splice()
+{
+    aisdi::LinkedList<int> list_ = {1, 5};
+    auto moved = list_.begin();
+    {
+        aisdi::LinkedList<int> other = {2, 3, 4};
+        moved = other.begin();
+        list_.splice(list_.begin() + 1, other);
+        if (!other.isEmpty())
+            list_.append(-1);
+    }
+    // The spliced nodes outlive the list that allocated them.
+    aisdi::LinkedList<int> rest = {6, 7, 8};
+    list_.splice(list_.end(), rest, rest.begin(), rest.begin() + 2);
+
+    // Once its nodes are released elsewhere, a spliced batch's memory goes
+    // too; many small splices must not pile it up.
+    aisdi::LinkedList<int> target;
+    std::size_t heldBefore = allocationCount - releaseCount;
+    for (int i = 0; i < 1000; i++)
+    {
+        aisdi::LinkedList<int> batch = {i, i + 1};
+        target.splice(target.end(), batch);
+        target.popFirst();
+        target.popFirst();
+    }
+    bool released = allocationCount - releaseCount - heldBefore < 16;
+
+    if (*moved == 2 && hasContents(list_, {1, 2, 3, 4, 5, 6, 7}) && hasContents(rest, {8}) && released)
+        std::cout << "Splice works." << std::endl;
+    else
+        std::cout << "Splice ERROR" << std::endl;
+}
+
+void test_splitAt()
+{
+    aisdi::LinkedList<int> list_ = {1, 2, 3, 4, 5};
+    aisdi::LinkedList<int> tail = list_.splitAt(list_.begin() + 2);
+    aisdi::LinkedList<int> empty = list_.splitAt(list_.end());
+    list_.append(9);
+    tail.prepend(0);
+    if (hasContents(list_, {1, 2, 9}) && hasContents(tail, {0, 3, 4, 5}) && empty.isEmpty())
+        std::cout << "SplitAt works." << std::endl;
+    else
+        std::cout << "SplitAt ERROR" << std::endl;
+}
+
+void test_merge()
+{
+    aisdi::LinkedList<int> list_ = {1, 4, 6, 9};
+    aisdi::LinkedList<int> other = {0, 4, 5, 10, 11};
+    list_.merge(other);
+    if (hasContents(list_, {0, 1, 4, 4, 5, 6, 9, 10, 11}) && other.isEmpty())
+        std::cout << "Merge works." << std::endl;
+    else
+        std::cout << "Merge ERROR" << std::endl;
+}
+
+void test_unrolledList()
+{
+    aisdi::UnrolledList<int, 4> list_ = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+    list_.insert(list_.begin() + 2, 0);
+    list_.erase(list_.begin() + 5, list_.begin() + 8);
+    list_.prepend(-1);
+
+    // The new element may be a copy of one that has to move to make room.
+    aisdi::UnrolledList<int, 4> aliased = {1, 2, 3};
+    aliased.insert(aliased.begin() + 1, *(aliased.begin() + 2));
+    aliased.append(*aliased.begin());
+    aliased.prepend(*(aliased.begin() + 2));
+    aliased.insert(aliased.begin() + 3, *(aliased.begin() + 4));
+    aisdi::UnrolledList<std::string, 4> words = {"a", "b", "c", "d"};
+    words.insert(words.begin() + 2, *(words.begin() + 3));
+    words.prepend(*(words.begin() + 4));
+    words.append(*(words.begin() + 1));
+
+    if (hasContents(list_, {-1, 1, 2, 0, 3, 4, 8, 9}) && list_.popLast() == 9 && list_.getNodeCount() <= 3
+        && hasContents(aliased, {2, 1, 3, 3, 2, 3, 1}) && hasContents(words, {"d", "a", "b", "d", "c", "d", "a"}))
+        std::cout << "UnrolledList works." << std::endl;
+    else
+        std::cout << "UnrolledList ERROR" << std::endl;
+}
+
+#ifdef __cpp_aligned_new
+struct alignas(64) CacheLineRecord
+{
+    int value;
+};
+
+// Links sit in front of each node; they must not push it off its alignment.
+bool overAlignedNodesWork()
+{
+    aisdi::IndexedList<CacheLineRecord> records;
+    bool aligned = true;
+    for (int i = 0; i < 100; i++)
+    {
+        records.insertAt(records.getSize() / 2, CacheLineRecord{i});
+        aligned = aligned && reinterpret_cast<std::uintptr_t>(&records.at(records.getSize() / 2)) % 64 == 0;
+    }
+    while (!records.isEmpty())
+        records.eraseAt(0);
+    return aligned;
+}
+#else
+bool overAlignedNodesWork()
+{
+    return true;
+}
+#endif
+
+void test_indexedList()
+{
+    aisdi::IndexedList<int> list_ = {0, 1, 2, 3, 4, 5, 6, 7};
+    auto stable = list_.iteratorAt(6);
+    list_.insertAt(3, 30);
+    list_.eraseAt(0);
+    list_.erase(list_.iteratorAt(1), list_.iteratorAt(3));
+    // Iterators survive positional edits elsewhere in the list.
+    if (hasContents(list_, {1, 3, 4, 5, 6, 7}) && list_.at(4) == 6 && *stable == 6
+        && list_.indexOf(stable) == 4 && list_.begin() + 4 == stable && list_.popLast() == 7 && overAlignedNodesWork())
+        std::cout << "IndexedList works." << std::endl;
+    else
+        std::cout << "IndexedList ERROR" << std::endl;
+}
+
+void test_concurrentQueue()
+{
+    aisdi::ConcurrentQueue<int> ordered;
+    for (int i = 0; i < 5; i++)
+        ordered.append(i);
+    int first = -1;
+    int second = -1;
+    bool fifo = ordered.tryPopFirst(first) && ordered.tryPopFirst(second) && first == 0 && second == 1;
+
+    aisdi::ConcurrentQueue<int> shared;
+    const std::size_t items = 10000;
+    std::size_t sum = produceConsume(shared, 3, 3, items);
+
+    // Far more elements pass through than are ever queued at once; the
+    // nodes consumers free have to come back to the producer.
+    aisdi::ConcurrentQueue<int> streamed;
+    const std::size_t streamedItems = 1000000;
+    const std::size_t backlog = 1000;
+    std::atomic<std::size_t> popped(0);
+    std::thread producer([&streamed, &popped, streamedItems, backlog] {
+        for (std::size_t i = 0; i < streamedItems; i++)
+        {
+            while (i - popped.load(std::memory_order_acquire) >= backlog)
+                std::this_thread::yield();
+            streamed.append(static_cast<int>(i));
+        }
+    });
+    bool inOrder = true;
+    for (std::size_t i = 0; i < streamedItems; i++)
+    {
+        int item;
+        while (!streamed.tryPopFirst(item))
+            std::this_thread::yield();
+        inOrder = inOrder && item == static_cast<int>(i);
+        popped.store(i + 1, std::memory_order_release);
+    }
+    producer.join();
+    bool bounded = streamed.getMemoryUsage() < 16 * backlog * (sizeof(void*) + sizeof(int)) + 4096;
+
+    if (fifo && sum == items * (items - 1) / 2 && shared.isEmpty() && !shared.tryPopFirst(first) && inOrder && bounded)
+        std::cout << "ConcurrentQueue works." << std::endl;
+    else
+        std::cout << "ConcurrentQueue ERROR" << std::endl;
+}
+
+void test_parallel()
+{
+    aisdi::ThreadPool pool(3);
+    aisdi::Vector<int> vector_;
+    for (int i = 0; i < 100000; i++)
+        vector_.append(i);
+    aisdi::parallelForEach(pool, vector_.begin(), vector_.end(), [](int& value) { value *= 2; });
+    aisdi::Vector<long long> squares(vector_.begin(), vector_.end());
+    aisdi::parallelTransform(pool, vector_.cbegin(), vector_.cend(), squares.begin(),
+                             [](int value) { return static_cast<long long>(value) * value; });
+    long long sum = aisdi::parallelReduce(pool, vector_.cbegin(), vector_.cend(), 0LL,
+                                          [](long long total, long long value) { return total + value; });
+    auto found = aisdi::parallelFind(pool, vector_.cbegin(), vector_.cend(), 150000);
+    auto missing = aisdi::parallelFindIf(pool, vector_.cbegin(), vector_.cend(), [](int value) { return value % 2 != 0; });
+    if (sum == 99999LL * 100000 && found - vector_.cbegin() == 75000 && missing == vector_.cend()
+            && *(squares.end() - 1) == 199998LL * 199998)
+        std::cout << "Parallel algorithms work." << std::endl;
+    else
+        std::cout << "Parallel algorithms ERROR" << std::endl;
+}
+
+// Every level the CPU runs has to agree with the scalar loops, for sizes
+// around each vector width and a start that is not vector aligned.
+template <typename Type>
+bool sameOrBothNaN(Type first, Type second)
+{
+    return first == second || (first != first && second != second);
+}
+
+template <typename Type>
+bool simdKernelsMatchScalar()
+{
+    typedef aisdi::SimdKernels<Type> Kernels;
+    aisdi::Vector<Type> values;
+    for (int i = 0; i < 300; i++)
+        values.append(static_cast<Type>((i * 7919) % 601 - 300));
+    for (std::size_t size = 1; size < values.getSize(); size++)
+    {
+        const Type* data = values.data() + 1;
+        const std::size_t length = size - 1;
+        const Type needle = values.data()[size / 2];
+        const aisdi::SumType<Type> expectedSum = Kernels::sum(data, length, aisdi::SimdLevel::Scalar);
+        for (int level = 1; level <= static_cast<int>(aisdi::detectSimdLevel()); level++)
+        {
+            const aisdi::SimdLevel simdLevel = static_cast<aisdi::SimdLevel>(level);
+            const aisdi::SumType<Type> sum = Kernels::sum(data, length, simdLevel);
+            if (Kernels::find(data, length, needle, simdLevel) != Kernels::find(data, length, needle, aisdi::SimdLevel::Scalar)
+                    || Kernels::count(data, length, needle, simdLevel) != Kernels::count(data, length, needle, aisdi::SimdLevel::Scalar)
+                    || (sum > expectedSum ? sum - expectedSum : expectedSum - sum) > aisdi::SumType<Type>(0.001))
+                return false;
+            if (length > 0 && (Kernels::min(data, length, simdLevel) != Kernels::min(data, length, aisdi::SimdLevel::Scalar)
+                    || Kernels::max(data, length, simdLevel) != Kernels::max(data, length, aisdi::SimdLevel::Scalar)))
+                return false;
+        }
+    }
+    // A NaN element must not wipe out what its lane has seen so far.
+    if (std::numeric_limits<Type>::has_quiet_NaN)
+        for (std::size_t nanAt : {0, 1, 65, 130, 298})
+        {
+            aisdi::Vector<Type> withNaN(values);
+            withNaN.data()[nanAt] = std::numeric_limits<Type>::quiet_NaN();
+            const Type* data = withNaN.data();
+            const std::size_t length = withNaN.getSize();
+            for (int level = 1; level <= static_cast<int>(aisdi::detectSimdLevel()); level++)
+            {
+                const aisdi::SimdLevel simdLevel = static_cast<aisdi::SimdLevel>(level);
+                if (!sameOrBothNaN(Kernels::min(data, length, simdLevel), Kernels::min(data, length, aisdi::SimdLevel::Scalar))
+                        || !sameOrBothNaN(Kernels::max(data, length, simdLevel), Kernels::max(data, length, aisdi::SimdLevel::Scalar)))
+                    return false;
+            }
+        }
+    return true;
+}
+
+void test_simdKernels()
+{
+    aisdi::Vector<int> vector_;
+    for (int i = 0; i < 1000; i++)
+        vector_.append(i - 500);
+    bool emptyThrows = false;
+    try
+    {
+        aisdi::min(aisdi::Vector<double>());
+    }
+    catch (const std::logic_error&)
+    {
+        emptyThrows = true;
+    }
+    if (simdKernelsMatchScalar<int>() && simdKernelsMatchScalar<float>() && simdKernelsMatchScalar<double>()
+            && aisdi::find(vector_, 250) - vector_.cbegin() == 750 && aisdi::indexOf(vector_, 1000) == vector_.getSize()
+            && aisdi::contains(vector_, -500) && aisdi::count(vector_, 7) == 1 && aisdi::min(vector_) == -500
+            && aisdi::max(vector_) == 499 && aisdi::sum(vector_) == -500 && emptyThrows)
+        std::cout << "SIMD kernels (" << aisdi::simdLevelName(aisdi::detectSimdLevel()) << ") work." << std::endl;
+    else
+        std::cout << "SIMD kernels ERROR" << std::endl;
+}
+
+#if AISDI_MAPPED_VECTOR
+void test_mappedVector()
+{
+    const std::string path = temporaryPath("test.bin");
+    std::remove(path.c_str());
+    bool works = true;
+    {
+        aisdi::MappedVector<int> vector_(path);
+        for (int i = 0; i < 10000; i++)
+            vector_.append(i);
+        vector_.prepend(-1);
+        vector_.erase(vector_.begin() + 1, vector_.begin() + 11);
+        vector_.popLast();
+        vector_.flush();
+    }
+    {
+        aisdi::MappedVector<int> reopened(path, aisdi::MapMode::ReadOnly);
+        works = reopened.getSize() == 9990 && *reopened.begin() == -1 && *(reopened.end() - 1) == 9998;
+        try
+        {
+            reopened.append(1);
+            works = false;
+        }
+        catch (const std::logic_error&)
+        {}
+    }
+    try
+    {
+        aisdi::MappedVector<double> wrongType(path, aisdi::MapMode::ReadOnly);
+        works = false;
+    }
+    catch (const std::runtime_error&)
+    {}
+    std::remove(path.c_str());
+
+    // Appending its own elements remaps the file they are read from.
+    const std::string doubledPath = temporaryPath("doubled.bin");
+    {
+        aisdi::MappedVector<int> doubled(doubledPath);
+        for (int i = 0; i < 100; i++)
+            doubled.append(i);
+        doubled.shrinkToFit();
+        doubled.append(doubled.begin(), doubled.end());
+        works = works && doubled.getSize() == 200 && *(doubled.begin() + 150) == 50 && *(doubled.end() - 1) == 99;
+
+        // A single-pass range can only be read once.
+        std::istringstream text("7 8 9");
+        doubled.append(std::istream_iterator<int>(text), std::istream_iterator<int>());
+        works = works && doubled.getSize() == 203 && *(doubled.end() - 3) == 7 && *(doubled.end() - 1) == 9;
+    }
+    std::remove(doubledPath.c_str());
+    if (works)
+        std::cout << "MappedVector works." << std::endl;
+    else
+        std::cout << "MappedVector ERROR" << std::endl;
+}
+#endif
+
+// Saves container, overwrites the uint64 at offset with a huge count or
+// length and checks that loading fails on the short input without
+// allocating what the data claims.
+template <typename Container>
+bool rejectsHugeCount(const Container& container, bool chunked, std::size_t offset)
+{
+    std::stringstream saved;
+    if (chunked)
+        aisdi::saveChunked(container, saved);
+    else
+        aisdi::save(container, saved);
+    std::string bytes = saved.str();
+    const std::uint64_t huge = static_cast<std::uint64_t>(1) << 60;
+    std::memcpy(&bytes[offset], &huge, sizeof(huge));
+    std::stringstream corrupt(bytes);
+    Container loaded;
+    try
+    {
+        aisdi::load(loaded, corrupt);
+        return false;
+    }
+    catch (const std::runtime_error&)
+    {
+        return loaded.isEmpty();
+    }
+}
+
+void test_serialization()
+{
+    aisdi::Vector<int> numbers;
+    aisdi::LinkedList<std::string> words;
+    for (int i = 0; i < 10000; i++)
+    {
+        numbers.append(i * 7);
+        words.append(std::string(i % 40, static_cast<char>('a' + i % 26)));
+    }
+    std::stringstream stream;
+    aisdi::save(numbers, stream);
+    aisdi::saveChunked(words, stream, 1000);
+    aisdi::Vector<int> loadedNumbers = {1, 2, 3};
+    aisdi::LinkedList<std::string> loadedWords;
+    aisdi::load(loadedNumbers, stream);
+    aisdi::load(loadedWords, stream);
+    bool works = loadedNumbers.getSize() == numbers.getSize() && loadedWords.getSize() == words.getSize()
+                 && std::equal(numbers.begin(), numbers.end(), loadedNumbers.begin())
+                 && std::equal(words.begin(), words.end(), loadedWords.begin());
+
+    std::stringstream truncated(stream.str().substr(0, 100));
+    try
+    {
+        aisdi::load(loadedNumbers, truncated);
+        works = false;
+    }
+    catch (const std::runtime_error&)
+    {
+        works = works && loadedNumbers.getSize() == numbers.getSize();
+    }
+
+    // The header count sits at 16; the 24-byte header is followed by the
+    // first chunk count when chunked, else by the first element.
+    aisdi::Vector<int> few = {1, 2, 3};
+    aisdi::LinkedList<std::string> named = {"first", "second"};
+    works = works && rejectsHugeCount(few, false, 16) && rejectsHugeCount(few, true, 24)
+            && rejectsHugeCount(named, true, 24) && rejectsHugeCount(named, false, 24) && rejectsHugeCount(named, true, 32);
+    if (works)
+        std::cout << "Serialization works." << std::endl;
+    else
+        std::cout << "Serialization ERROR" << std::endl;
+}
+
+void test_segmentedVector()
+{
+    aisdi::SegmentedVector<int, 4> vector_ = {0, 1, 2};
+    const int* first = &vector_[0];
+    for (int i = 3; i < 1000; i++)
+        vector_.append(i);
+    bool works = &vector_[0] == first && vector_.getSize() == 1000 && vector_.at(999) == 999
+                 && vector_.getCapacity() == 1020 && vector_.cend() - vector_.cbegin() == 1000;
+    int expected = 0;
+    for (auto it = vector_.begin(); it != vector_.end(); ++it)
+        works = works && *it == expected++;
+    auto it = vector_.end();
+    for (expected = 999; expected >= 0; expected--)
+        works = works && *--it == expected;
+    works = works && *(vector_.begin() + 500) == 500 && vector_.begin()[28] == 28 && vector_.popLast() == 999;
+    bool outOfRange = false;
+    try
+    {
+        vector_.at(999);
+    }
+    catch (const std::out_of_range&)
+    {
+        outOfRange = true;
+    }
+    while (!vector_.isEmpty())
+        vector_.popLast();
+    vector_.shrinkToFit();
+    // end() of a full vector names a block that does not exist yet; it
+    // has to reach the element appended there.
+    aisdi::SegmentedVector<int, 4> full = {0, 1, 2, 3};
+    auto appended = full.end();
+    full.append(4);
+    full.append(5);
+    works = works && *appended == 4 && *++appended == 5 && ++appended == full.end();
+    aisdi::SegmentedVector<std::string> words = {"first", "second"};
+    aisdi::SegmentedVector<std::string> moved(std::move(words));
+    words = moved;
+    if (works && outOfRange && vector_.getCapacity() == 0 && words.at(1) == "second" && moved.getSize() == 2)
+        std::cout << "SegmentedVector works." << std::endl;
+    else
+        std::cout << "SegmentedVector ERROR" << std::endl;
+}
+
+template <typename Collection>
+bool predicateEraseWorks()
+{
+    Collection numbers = {1, 1, 2, 3, 3, 3, 4, 1, 1, 5};
+    bool works = numbers.eraseIf([](int value) { return value % 2 == 1 && value > 1; }) == 4
+                 && hasContents(numbers, {1, 1, 2, 4, 1, 1});
+    // The value removed is an element of the collection itself.
+    works = works && numbers.remove(*numbers.begin()) == 4 && hasContents(numbers, {2, 4});
+    Collection runs = {1, 1, 2, 3, 3, 3, 4, 1, 1, 5};
+    works = works && runs.unique() == 4 && hasContents(runs, {1, 2, 3, 4, 1, 5});
+    // Runs are compared with the first element of the run, not the previous one.
+    Collection steps = {1, 2, 3, 4, 7, 8};
+    works = works && steps.unique([](int first, int second) { return second - first < 2; }) == 3
+            && hasContents(steps, {1, 3, 7});
+    Collection unchanged = {1, 2, 3};
+    return works && unchanged.eraseIf([](int) { return false; }) == 0 && unchanged.unique() == 0
+           && unchanged.remove(4) == 0 && hasContents(unchanged, {1, 2, 3});
+}
+
+void test_eraseIf()
+{
+    if (predicateEraseWorks<aisdi::Vector<int>>() && predicateEraseWorks<aisdi::LinkedList<int>>())
+        std::cout << "EraseIf works." << std::endl;
+    else
+        std::cout << "EraseIf ERROR" << std::endl;
+}
+
+template <typename Collection>
+bool sortWorks(std::initializer_list<int> values)
+{
+    Collection ascending = values;
+    Collection descending = values;
+    ascending.sort();
+    descending.sort(std::greater<int>());
+    std::vector<int> expected(values);
+    std::sort(expected.begin(), expected.end());
+    return std::equal(expected.begin(), expected.end(), ascending.begin())
+           && std::equal(expected.rbegin(), expected.rend(), descending.begin());
+}
+
+void test_sort()
+{
+    // Long enough for the radix path of Vector<int>, with negative numbers.
+    aisdi::Vector<int> numbers;
+    for (int i = 0; i < 1000; i++)
+        numbers.append((i * 7919) % 2003 - 1001);
+    numbers.sort();
+    bool works = numbers.getSize() == 1000 && std::is_sorted(numbers.begin(), numbers.end());
+    works = works && sortWorks<aisdi::Vector<int>>({5, -3, 9, 0, 5, 2}) && sortWorks<aisdi::LinkedList<int>>({5, -3, 9, 0, 5, 2})
+            && sortWorks<aisdi::Vector<int>>({}) && sortWorks<aisdi::LinkedList<int>>({1});
+    // The list sort is stable and relinks nodes, so iterators follow their elements.
+    aisdi::LinkedList<std::pair<int, int>> pairs = {{2, 0}, {1, 1}, {2, 2}, {0, 3}, {1, 4}};
+    auto first = pairs.begin();
+    pairs.sort([](const std::pair<int, int>& a, const std::pair<int, int>& b) { return a.first < b.first; });
+    int expected[] = {3, 1, 4, 0, 2};
+    int i = 0;
+    for (const auto& item : pairs)
+        works = works && item.second == expected[i++];
+    works = works && (*first).second == 0 && first + 1 == pairs.end() - 1;
+    if (works)
+        std::cout << "Sort works." << std::endl;
+    else
+        std::cout << "Sort ERROR" << std::endl;
+}
+
+void test_compact()
+{
+    aisdi::LinkedList<int> list_ = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    list_.sort([](int first, int second) { return (first * 7) % 10 < (second * 7) % 10; });
+    std::vector<int> before(list_.begin(), list_.end());
+    list_.compact();
+    // Same order, and the nodes now lie in it one after another.
+    bool works = std::equal(before.begin(), before.end(), list_.begin()) && list_.getSize() == 10;
+    for (auto it = list_.begin(); it + 1 != list_.end(); ++it)
+        works = works && &*it < &*(it + 1);
+    aisdi::LinkedList<std::string, aisdi::NodeHeap> words = {"first", "second"};
+    words.compact();
+    words.append("third");
+    aisdi::LinkedList<int> empty;
+    empty.compact();
+
+    // Compacting leaves the arena alone; only new nodes draw on it.
+    ArenaList arenaList(100);
+    for (int i = 0; i < 100; i++)
+        arenaList.list.append(i);
+    std::size_t arenaLeft = arenaList.arena.remaining();
+    for (int i = 0; i < 1000; i++)
+        arenaList.list.compact();
+    works = works && arenaList.arena.remaining() == arenaLeft && arenaList.list.getSize() == 100;
+    for (int i = 0; i < 100; i++)
+        arenaList.list.append(i);
+    works = works && arenaList.arena.remaining() < arenaLeft;
+
+    if (works && hasContents(list_, {0, 3, 6, 9, 2, 5, 8, 1, 4, 7}) && words.getSize() == 3
+        && *(words.begin() + 1) == "second" && empty.isEmpty())
+        std::cout << "Compact works." << std::endl;
+    else
+        std::cout << "Compact ERROR" << std::endl;
+}
+
+bool optionValue(const std::string& argument, const std::string& option, std::string& value)
+{
+    if (argument.compare(0, option.size(), option) != 0)
+        return false;
+    value = argument.substr(option.size());
+    return true;
+}
+
+std::vector<std::size_t> parseSizes(const std::string& text)
+{
+    std::vector<std::size_t> sizes;
+    std::size_t start = 0;
+    while (start <= text.size())
+    {
+        std::size_t comma = text.find(',', start);
+        if (comma == std::string::npos)
+            comma = text.size();
+        if (comma > start)
+            sizes.push_back(std::stoull(text.substr(start, comma - start)));
+        start = comma + 1;
+    }
+    return sizes;
+}
+
+void printUsage(const char* program)
+{
+    std::cerr << "usage: " << program << " [repeatCount] [--format=table|csv|json] [--output=FILE]\n"
+              << "       [--filter=TEXT] [--sizes=N,N,...] [--repetitions=N] [--warmups=N] [--no-tests]\n"
+              << "       [--parallel-size=N] [--sort-size=N] [--stats=FILE]\n"
+              << "  repeatCount   perfomTest calls per repetition of the string payload benchmarks\n"
+              << "  --filter      run only benchmarks whose container/benchmark/type contains TEXT\n"
+              << "  --parallel-size  elements of the parallel algorithm benchmarks (0 skips them)\n"
+              << "  --sort-size   elements of the largest sort benchmarks, run besides --sizes (0 skips it)\n"
+              << "  --stats       write the Vector and LinkedList totals of the run to FILE as JSON\n"
+              << "                (all zeros unless built with -DAISDI_STATS=1)\n";
+}
+
 int main(int argc, char** argv)
 {
-  const std::size_t repeatCount = argc > 1 ? std::atoll(argv[1]) : 10000;
-  for (std::size_t i = 0; i < repeatCount; ++i)
-    perfomTest();
-
-  test_popFirst_list();
-  test_popFirst_vector();
-  test_getCapacity();
-  test_add_memory();
-  performAppend(1000, 10);
-  performAppend(10000, 100);
-  performAppend(100000, 100);
-  performAppend(1000000, 100);
+  std::size_t repeatCount = 1000;
+  std::size_t repetitions = 11;
+  std::size_t warmups = 1;
+  std::string format = "table";
+  std::string output;
+  std::string filter;
+  std::string statsOutput;
+  std::vector<std::size_t> sizes = {1000, 100000, 1000000};
+  std::size_t parallelSize = 100000000;
+  std::size_t sortSize = 10000000;
+  bool runTests = true;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string argument = argv[i];
+    std::string value;
+    if (optionValue(argument, "--format=", value) && (value == "table" || value == "csv" || value == "json"))
+      format = value;
+    else if (optionValue(argument, "--output=", value))
+      output = value;
+    else if (optionValue(argument, "--filter=", value))
+      filter = value;
+    else if (optionValue(argument, "--sizes=", value))
+      sizes = parseSizes(value);
+    else if (optionValue(argument, "--repetitions=", value))
+      repetitions = std::stoull(value);
+    else if (optionValue(argument, "--warmups=", value))
+      warmups = std::stoull(value);
+    else if (optionValue(argument, "--parallel-size=", value))
+      parallelSize = std::stoull(value);
+    else if (optionValue(argument, "--sort-size=", value))
+      sortSize = std::stoull(value);
+    else if (optionValue(argument, "--stats=", value))
+      statsOutput = value;
+    else if (argument == "--no-tests")
+      runTests = false;
+    else if (!argument.empty() && argument.find_first_not_of("0123456789") == std::string::npos)
+      repeatCount = std::stoull(argument);
+    else
+    {
+      printUsage(argv[0]);
+      return 1;
+    }
+  }
+
+  if (runTests)
+  {
+    test_popFirst_list();
+    test_popFirst_vector();
+    test_getCapacity();
+    test_add_memory();
+    test_reserve();
+    test_shrinkToFit();
+    test_growthPolicy();
+    test_smallVector();
+    test_allocators();
+    test_stats();
+    test_splice();
+    test_splitAt();
+    test_merge();
+    test_unrolledList();
+    test_indexedList();
+    test_concurrentQueue();
+    test_parallel();
+    test_simdKernels();
+#if AISDI_MAPPED_VECTOR
+    test_mappedVector();
+#endif
+    test_serialization();
+    test_segmentedVector();
+    test_eraseIf();
+    test_sort();
+    test_compact();
+  }
+
+  aisdi::BenchmarkSuite suite(repetitions, warmups, filter);
+  suite.addContext("compiler", __VERSION__);
+  suite.addContext("checked_iterators", AISDI_CHECKED_ITERATORS ? "true" : "false");
+  suite.addContext("stats", AISDI_STATS ? "true" : "false");
+  suite.addContext("prefetch", AISDI_PREFETCH ? "true" : "false");
+  suite.addContext("simd", aisdi::simdLevelName(aisdi::detectSimdLevel()));
+#ifdef NDEBUG
+  suite.addContext("ndebug", "true");
+#else
+  suite.addContext("ndebug", "false");
+#endif
+
+  registerContainerBenchmarks<aisdi::Vector<int>>(suite, "Vector", sizes);
+  registerContainerBenchmarks<aisdi::Vector<std::string>>(suite, "Vector", sizes);
+  registerContainerBenchmarks<aisdi::Vector<LargePod>>(suite, "Vector", sizes);
+  registerContainerBenchmarks<aisdi::SmallVector<int, 16>>(suite, "SmallVector<16>", sizes);
+  registerContainerBenchmarks<aisdi::LinkedList<int>>(suite, "LinkedList", sizes);
+  registerContainerBenchmarks<aisdi::LinkedList<std::string>>(suite, "LinkedList", sizes);
+  registerContainerBenchmarks<aisdi::LinkedList<LargePod>>(suite, "LinkedList", sizes);
+  registerContainerBenchmarks<aisdi::UnrolledList<int>>(suite, "UnrolledList", sizes);
+  registerContainerBenchmarks<aisdi::UnrolledList<std::string>>(suite, "UnrolledList", sizes);
+  registerContainerBenchmarks<aisdi::UnrolledList<LargePod>>(suite, "UnrolledList", sizes);
+  registerContainerBenchmarks<aisdi::IndexedList<int>>(suite, "IndexedList", sizes);
+  registerContainerBenchmarks<aisdi::IndexedList<std::string>>(suite, "IndexedList", sizes);
+  registerContainerBenchmarks<aisdi::IndexedList<LargePod>>(suite, "IndexedList", sizes);
+  registerRawPointerBenchmarks(suite, sizes);
+  registerNodeStorageBenchmarks(suite, sizes);
+  registerStringPayloadBenchmarks<aisdi::LinkedList<std::string>>(suite, "LinkedList", repeatCount);
+  registerStringPayloadBenchmarks<aisdi::Vector<std::string>>(suite, "Vector", repeatCount);
+  registerStringPayloadBenchmarks<aisdi::SmallVector<std::string, payloadCount>>(suite, "SmallVector<100>", repeatCount);
+  registerShortSequenceBenchmarks<aisdi::Vector<int>>(suite, "Vector");
+  registerShortSequenceBenchmarks<aisdi::SmallVector<int, 16>>(suite, "SmallVector<16>");
+  registerShortSequenceBenchmarks<aisdi::LinkedList<int>>(suite, "LinkedList");
+#if AISDI_PMR
+  registerAllocatorBenchmarks(suite);
+#endif
+  registerShiftBenchmarks<int>(suite, sizes);
+  registerShiftBenchmarks<CopyableInt>(suite, sizes);
+  registerSpliceBenchmarks(suite, sizes);
+  registerPositionalBenchmarks<aisdi::Vector<int>>(suite, "Vector", sizes);
+  registerPositionalBenchmarks<aisdi::LinkedList<int>>(suite, "LinkedList", sizes);
+  registerPositionalBenchmarks<aisdi::IndexedList<int>>(suite, "IndexedList", sizes);
+  registerQueueBenchmarks<aisdi::ConcurrentQueue<int>>(suite, "ConcurrentQueue");
+  registerQueueBenchmarks<MutexQueue<int>>(suite, "MutexQueue<LinkedList>");
+  registerParallelBenchmarks(suite, parallelSize);
+  registerSimdBenchmarks<int>(suite, sizes);
+  registerSimdBenchmarks<float>(suite, sizes);
+  registerSimdBenchmarks<double>(suite, sizes);
+#if AISDI_MAPPED_VECTOR
+  registerMappedStartupBenchmarks(suite, sizes);
+#endif
+  registerSerializationBenchmarks<aisdi::Vector<int>>(suite, "Vector", sizes);
+  registerSerializationBenchmarks<aisdi::LinkedList<int>>(suite, "LinkedList", sizes);
+  registerSegmentedBenchmarks<int>(suite, sizes);
+  registerSegmentedBenchmarks<LargePod>(suite, sizes);
+  registerEraseIfBenchmarks<aisdi::Vector<int>>(suite, "Vector", sizes);
+  registerEraseIfBenchmarks<aisdi::LinkedList<int>>(suite, "LinkedList", sizes);
+  registerSortBenchmarks(suite, sizes, sortSize);
+  registerCompactBenchmarks(suite, sizes);
+
+  std::ofstream file;
+  if (!output.empty())
+  {
+    file.open(output);
+    if (!file)
+    {
+      std::cerr << "Cannot open " << output << std::endl;
+      return 1;
+    }
+  }
+  std::ostream& out = output.empty() ? std::cout : file;
+  if (format == "csv")
+    suite.writeCsv(out);
+  else if (format == "json")
+    suite.writeJson(out);
+  else
+    suite.writeTable(out);
+
+  if (!statsOutput.empty())
+  {
+    std::ofstream statsFile(statsOutput);
+    aisdi::writeGlobalStatsJson(statsFile);
+    statsFile << "\n";
+    if (!statsFile)
+    {
+      std::cerr << "Cannot write " << statsOutput << std::endl;
+      return 1;
+    }
+  }
   return 0;
 }